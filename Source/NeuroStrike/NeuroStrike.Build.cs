@@ -9,6 +9,9 @@ public class NeuroStrike : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new[]
-			{ "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput" });
+			{ "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "ReplicationGraph", "AIModule",
+			  "AnimationBudgetAllocator" });
+
+		PrivateDependencyModuleNames.AddRange(new[] { "Json", "RenderCore" });
 	}
 }
@@ -1,6 +1,109 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "NeuroStrike.h"
+#include "NeuroStrikeReplicationGraph.h"
+#include "Engine/NetDriver.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
 #include "Modules/ModuleManager.h"
+#include "UObject/UObjectArray.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE(FDefaultGameModuleImpl, NeuroStrike, "NeuroStrike");
+#if WITH_EDITOR
+#include "Interfaces/ITargetPlatform.h"
+#endif
+
+DEFINE_LOG_CATEGORY(LogNeuroStrike);
+
+DEFINE_STAT(STAT_NeuroStrike_LiveProjectiles);
+DEFINE_STAT(STAT_NeuroStrike_ShotsFired);
+DEFINE_STAT(STAT_NeuroStrike_ShotsPerSecond);
+DEFINE_STAT(STAT_NeuroStrike_DamageEvents);
+DEFINE_STAT(STAT_NeuroStrike_RPC_ServerStartFiring);
+DEFINE_STAT(STAT_NeuroStrike_RPC_ServerStopFiring);
+DEFINE_STAT(STAT_NeuroStrike_RPC_ServerDespawn);
+DEFINE_STAT(STAT_NeuroStrike_RPC_Throttled);
+DEFINE_STAT(STAT_NeuroStrike_FireStateUpdates);
+DEFINE_STAT(STAT_NeuroStrike_RPC_MulticastOnKills);
+
+namespace NeuroStrikeStats {
+	/** Shots fired since the shots-per-second stat was last refreshed. */
+	static int32 ShotsInWindow = 0;
+
+	/** Platform time at which the current shots-per-second window started. */
+	static double WindowStartTime = 0.0;
+
+	void RecordShot() {
+		INC_DWORD_STAT(STAT_NeuroStrike_ShotsFired);
+		++ShotsInWindow;
+	}
+
+	/** Refreshes the shots-per-second stat once a second, at the end of a frame. */
+	static void UpdateShotRate() {
+		const double Now = FPlatformTime::Seconds();
+		const double Elapsed = Now - WindowStartTime;
+		if (Elapsed < 1.0) {
+			return;
+		}
+
+		SET_FLOAT_STAT(STAT_NeuroStrike_ShotsPerSecond, WindowStartTime > 0.0 ? ShotsInWindow / Elapsed : 0.0);
+		ShotsInWindow = 0;
+		WindowStartTime = Now;
+	}
+
+	void LogMemoryReport(const TCHAR* Context) {
+		const FPlatformMemoryStats Stats = FPlatformMemory::GetStats();
+		UE_LOG(LogNeuroStrike, Log,
+		       TEXT("Memory (%s): %.1f MiB resident, %.1f MiB peak, %.1f MiB virtual, %d objects, up %.1f s"),
+		       Context, Stats.UsedPhysical / (1024.0 * 1024.0), Stats.PeakUsedPhysical / (1024.0 * 1024.0),
+		       Stats.UsedVirtual / (1024.0 * 1024.0), GUObjectArray.GetObjectArrayNumMinusAvailable(),
+		       FPlatformTime::Seconds() - GStartTime);
+	}
+
+	static FAutoConsoleCommand MemoryReportCommand(
+		TEXT("NeuroStrike.Memory.Report"),
+		TEXT("Logs the resident, peak and virtual memory of this process and its number of live objects."),
+		FConsoleCommandDelegate::CreateLambda([]() {
+			LogMemoryReport(TEXT("on request"));
+		}));
+}
+
+#if WITH_EDITOR
+namespace NeuroStrikeCook {
+	bool IsCookingForServer(const FArchive& Ar) {
+		const ITargetPlatform* Target = Ar.IsSaving() && Ar.IsCooking() ? Ar.CookingTarget() : nullptr;
+		return Target != nullptr && Target->IsServerOnly();
+	}
+}
+#endif
+
+/**
+ * Game module that installs the NeuroStrike replication graph on the game net driver of every game world,
+ * and keeps the rate-based NeuroStrike stats up to date.
+ */
+class FNeuroStrikeModule : public FDefaultGameModuleImpl {
+public:
+	virtual void StartupModule() override {
+		UReplicationDriver::CreateReplicationDriverDelegate().BindLambda(
+			[](UNetDriver* ForNetDriver, const FURL& URL, UWorld* World) -> UReplicationDriver* {
+				if (World == nullptr || !World->IsGameWorld() || ForNetDriver->NetDriverName != NAME_GameNetDriver) {
+					return nullptr;
+				}
+
+				return NewObject<UNeuroStrikeReplicationGraph>(GetTransientPackage());
+			});
+
+		this->EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&NeuroStrikeStats::UpdateShotRate);
+	}
+
+	virtual void ShutdownModule() override {
+		FCoreDelegates::OnEndFrame.Remove(this->EndFrameHandle);
+		UReplicationDriver::CreateReplicationDriverDelegate().Unbind();
+	}
+
+private:
+	FDelegateHandle EndFrameHandle;
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE(FNeuroStrikeModule, NeuroStrike, "NeuroStrike");
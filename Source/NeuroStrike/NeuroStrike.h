@@ -3,3 +3,78 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+/** Log category shared by the NeuroStrike gameplay systems that are not tied to a single actor. */
+DECLARE_LOG_CATEGORY_EXTERN(LogNeuroStrike, Log, All);
+
+/** On-screen gameplay debug overlays are only compiled into builds that can display them. */
+#define NEUROSTRIKE_WITH_DEBUG_OVERLAY (!UE_BUILD_SHIPPING && !UE_SERVER)
+
+/**
+ * Object channel of NeuroStrike projectiles, the "Projectile" channel of DefaultEngine.ini. Projectiles set their
+ * own responses in code and ignore everything but characters and world-static geometry, unless their class opts
+ * into more with AdditionalBlockingChannels.
+ */
+#define ECC_NeuroStrikeProjectile ECC_GameTraceChannel1
+
+/** Stat group of the NeuroStrike gameplay hot paths, shown with `stat NeuroStrike`. */
+DECLARE_STATS_GROUP(TEXT("NeuroStrike"), STATGROUP_NeuroStrike, STATCAT_Advanced);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Projectiles"), STAT_NeuroStrike_LiveProjectiles,
+                                      STATGROUP_NeuroStrike, NEUROSTRIKE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Shots Fired"), STAT_NeuroStrike_ShotsFired, STATGROUP_NeuroStrike,
+                                  NEUROSTRIKE_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Shots Per Second"), STAT_NeuroStrike_ShotsPerSecond,
+                                      STATGROUP_NeuroStrike, NEUROSTRIKE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Damage Events Processed"), STAT_NeuroStrike_DamageEvents,
+                                  STATGROUP_NeuroStrike, NEUROSTRIKE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RPC ServerStartFiring"), STAT_NeuroStrike_RPC_ServerStartFiring,
+                                  STATGROUP_NeuroStrike, NEUROSTRIKE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RPC ServerStopFiring"), STAT_NeuroStrike_RPC_ServerStopFiring,
+                                  STATGROUP_NeuroStrike, NEUROSTRIKE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RPC ServerDespawn"), STAT_NeuroStrike_RPC_ServerDespawn,
+                                  STATGROUP_NeuroStrike, NEUROSTRIKE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RPC Throttled"), STAT_NeuroStrike_RPC_Throttled, STATGROUP_NeuroStrike,
+                                  NEUROSTRIKE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Fire State Updates"), STAT_NeuroStrike_FireStateUpdates,
+                                  STATGROUP_NeuroStrike, NEUROSTRIKE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("RPC Multicast_OnKills"), STAT_NeuroStrike_RPC_MulticastOnKills,
+                                  STATGROUP_NeuroStrike, NEUROSTRIKE_API);
+
+/**
+ * Times the enclosing scope both as a cycle stat of the NeuroStrike group and as a CPU event of Unreal Insights
+ * traces, so hot paths show up with `stat NeuroStrike` as well as in a `-trace=cpu` capture.
+ *
+ * @param Description Display name of the scope.
+ * @param StatName Unique name of the cycle stat.
+ */
+#define NEUROSTRIKE_SCOPE_CYCLE_COUNTER(Description, StatName) \
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT(Description), StatName, STATGROUP_NeuroStrike); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR(Description)
+
+namespace NeuroStrikeStats {
+	/** Counts a shot fired by the server towards the shot counters. */
+	NEUROSTRIKE_API void RecordShot();
+
+	/**
+	 * Logs the memory used by this process and the number of live objects.
+	 *
+	 * @param Context What prompted the report, logged with it.
+	 */
+	NEUROSTRIKE_API void LogMemoryReport(const TCHAR* Context);
+}
+
+#if WITH_EDITOR
+namespace NeuroStrikeCook {
+	/**
+	 * Whether an archive is saving a package cooked for a server-only platform. Objects serialize their cosmetic
+	 * soft references without collecting them there, so the assets they point to stay out of server cooks.
+	 *
+	 * @param Ar The archive.
+	 * @return true when cooking for a dedicated server.
+	 */
+	NEUROSTRIKE_API bool IsCookingForServer(const FArchive& Ar);
+}
+#endif
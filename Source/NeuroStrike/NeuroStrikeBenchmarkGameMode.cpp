@@ -0,0 +1,313 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeBenchmarkGameMode.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeBotController.h"
+#include "NeuroStrikeCharacter.h"
+#include "TP_WeaponComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace NeuroStrikeBenchmark {
+	/**
+	 * Summarizes samples as their average, maximum and usual percentiles.
+	 *
+	 * @param Samples The samples, in milliseconds.
+	 * @return A JSON object with one field per statistic.
+	 */
+	TSharedRef<FJsonObject> Summarize(TArray<float> Samples) {
+		TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+		Summary->SetNumberField(TEXT("Count"), Samples.Num());
+		if (Samples.IsEmpty()) {
+			return Summary;
+		}
+
+		Samples.Sort();
+
+		double Total = 0.0;
+		for (const float Sample : Samples) {
+			Total += Sample;
+		}
+
+		const auto Percentile = [&Samples](float Fraction) {
+			const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Samples.Num()) - 1, 0, Samples.Num() - 1);
+			return Samples[Index];
+		};
+
+		Summary->SetNumberField(TEXT("Average"), Total / Samples.Num());
+		Summary->SetNumberField(TEXT("P50"), Percentile(0.50f));
+		Summary->SetNumberField(TEXT("P90"), Percentile(0.90f));
+		Summary->SetNumberField(TEXT("P95"), Percentile(0.95f));
+		Summary->SetNumberField(TEXT("P99"), Percentile(0.99f));
+		Summary->SetNumberField(TEXT("Max"), Samples.Last());
+		return Summary;
+	}
+}
+
+ANeuroStrikeBenchmarkGameMode::ANeuroStrikeBenchmarkGameMode() : Super() {
+	this->PrimaryActorTick.bCanEverTick = true;
+	this->PrimaryActorTick.bTickEvenWhenPaused = true;
+
+	this->BotWeaponClass = TSoftClassPtr<AActor>(
+		FSoftObjectPath(TEXT("/Game/FirstPerson/Blueprints/BP_Pickup_Rifle.BP_Pickup_Rifle_C")));
+	this->BotControllerClass = ANeuroStrikeBotController::StaticClass();
+}
+
+void ANeuroStrikeBenchmarkGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) {
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	this->NumBots = FMath::Max(UGameplayStatics::GetIntOption(Options, TEXT("Bots"), this->NumBots), 0);
+
+	if (UGameplayStatics::HasOption(Options, TEXT("Warmup"))) {
+		this->WarmupDuration = FMath::Max(FCString::Atof(*UGameplayStatics::ParseOption(Options, TEXT("Warmup"))),
+		                                  0.0f);
+	}
+	if (UGameplayStatics::HasOption(Options, TEXT("Duration"))) {
+		this->BenchmarkDuration = FMath::Max(
+			FCString::Atof(*UGameplayStatics::ParseOption(Options, TEXT("Duration"))), 1.0f);
+	}
+	if (UGameplayStatics::HasOption(Options, TEXT("Exit"))) {
+		this->bExitWhenDone = UGameplayStatics::GetIntOption(Options, TEXT("Exit"), 1) != 0;
+	}
+
+	this->ReportFileName = UGameplayStatics::ParseOption(Options, TEXT("Report"));
+	if (this->ReportFileName.IsEmpty()) {
+		this->ReportFileName = FString::Printf(TEXT("Benchmark-%s.json"), *FDateTime::Now().ToString());
+	}
+}
+
+void ANeuroStrikeBenchmarkGameMode::StartPlay() {
+	Super::StartPlay();
+
+	if (!this->BotPawnClass.IsNull()) {
+		this->BotPawnClass.LoadSynchronous();
+	}
+	if (!this->BotWeaponClass.IsNull()) {
+		this->BotWeaponClass.LoadSynchronous();
+	}
+
+	for (int32 Index = 0; Index < this->NumBots; ++Index) {
+		this->SpawnBot();
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	this->MeasureStartTime = Now + this->WarmupDuration;
+	this->MeasureEndTime = this->MeasureStartTime + this->BenchmarkDuration;
+
+	UE_LOG(LogNeuroStrike, Display, TEXT("Benchmark: %d bots, %.1fs warmup, %.1fs measured"), this->Bots.Num(),
+	       this->WarmupDuration, this->BenchmarkDuration);
+}
+
+void ANeuroStrikeBenchmarkGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (this->bMeasuring) {
+		this->FinishBenchmark();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANeuroStrikeBenchmarkGameMode::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	if (this->bFinished) {
+		return;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (!this->bMeasuring) {
+		if (Now < this->MeasureStartTime) {
+			return;
+		}
+
+		this->bMeasuring = true;
+		this->ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(
+			FOnActorSpawned::FDelegate::CreateUObject(this, &ANeuroStrikeBenchmarkGameMode::OnActorSpawned));
+		this->PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(
+			this, &ANeuroStrikeBenchmarkGameMode::OnPreGarbageCollect);
+		this->PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(
+			this, &ANeuroStrikeBenchmarkGameMode::OnPostGarbageCollect);
+
+		if (const UNetDriver* NetDriver = GetWorld()->GetNetDriver()) {
+			for (const UNetConnection* Connection : NetDriver->ClientConnections) {
+				if (Connection != nullptr) {
+					this->StartBytesPerConnection.Add(Connection->LowLevelGetRemoteAddress(true),
+					                                  {Connection->InTotalBytes, Connection->OutTotalBytes});
+				}
+			}
+		}
+
+		const int32 ExpectedFrames = FMath::CeilToInt(this->BenchmarkDuration * 120.0f);
+		this->FrameTimes.Reserve(ExpectedFrames);
+		this->GameThreadTimes.Reserve(ExpectedFrames);
+		this->RenderThreadTimes.Reserve(ExpectedFrames);
+		return;
+	}
+
+	// The thread times are those of the previous frame, which is the most recent complete one.
+	this->FrameTimes.Add(FApp::GetDeltaTime() * 1000.0);
+	this->GameThreadTimes.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+	this->RenderThreadTimes.Add(FPlatformTime::ToMilliseconds(GRenderThreadTime));
+
+	if (Now >= this->MeasureEndTime) {
+		this->FinishBenchmark();
+	}
+}
+
+UClass* ANeuroStrikeBenchmarkGameMode::GetDefaultPawnClassForController_Implementation(AController* InController) {
+	if (InController != nullptr && InController->IsA<ANeuroStrikeBotController>()) {
+		if (UClass* PawnClass = this->BotPawnClass.Get()) {
+			return PawnClass;
+		}
+	}
+
+	return Super::GetDefaultPawnClassForController_Implementation(InController);
+}
+
+void ANeuroStrikeBenchmarkGameMode::SpawnBot() {
+	UClass* ControllerClass = this->BotControllerClass != nullptr
+		                          ? this->BotControllerClass.Get()
+		                          : ANeuroStrikeBotController::StaticClass();
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	ANeuroStrikeBotController* Bot = GetWorld()->SpawnActor<ANeuroStrikeBotController>(
+		ControllerClass, FTransform::Identity, SpawnParameters);
+	if (Bot == nullptr) {
+		return;
+	}
+
+	this->Bots.Add(Bot);
+	this->RestartPlayer(Bot);
+	this->ArmBot(Bot->GetPawn());
+}
+
+void ANeuroStrikeBenchmarkGameMode::ArmBot(APawn* Pawn) const {
+	ANeuroStrikeCharacter* Character = Cast<ANeuroStrikeCharacter>(Pawn);
+	UClass* WeaponClass = this->BotWeaponClass.Get();
+	if (Character == nullptr || WeaponClass == nullptr) {
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Owner = Character;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	const AActor* Pickup = GetWorld()->SpawnActor<AActor>(WeaponClass, Character->GetActorTransform(),
+	                                                      SpawnParameters);
+	if (Pickup == nullptr) {
+		return;
+	}
+
+	if (UTP_WeaponComponent* Weapon = Pickup->FindComponentByClass<UTP_WeaponComponent>()) {
+		Weapon->AttachWeapon(Character);
+	}
+}
+
+void ANeuroStrikeBenchmarkGameMode::FinishBenchmark() {
+	this->bMeasuring = false;
+	this->bFinished = true;
+
+	if (UWorld* World = GetWorld()) {
+		World->RemoveOnActorSpawnedHandler(this->ActorSpawnedHandle);
+	}
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(this->PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(this->PostGarbageCollectHandle);
+
+	this->WriteReport();
+
+	if (this->bExitWhenDone) {
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void ANeuroStrikeBenchmarkGameMode::WriteReport() const {
+	const UWorld* World = GetWorld();
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("Map"), UWorld::RemovePIEPrefix(World->GetMapName()));
+	Report->SetStringField(TEXT("Date"), FDateTime::Now().ToIso8601());
+	Report->SetNumberField(TEXT("Bots"), this->Bots.Num());
+	Report->SetNumberField(TEXT("Duration"), this->BenchmarkDuration);
+	Report->SetObjectField(TEXT("FrameTime"), NeuroStrikeBenchmark::Summarize(this->FrameTimes));
+	Report->SetObjectField(TEXT("GameThreadTime"), NeuroStrikeBenchmark::Summarize(this->GameThreadTimes));
+	Report->SetObjectField(TEXT("RenderThreadTime"), NeuroStrikeBenchmark::Summarize(this->RenderThreadTimes));
+	Report->SetObjectField(TEXT("GarbageCollection"), NeuroStrikeBenchmark::Summarize(this->GarbageCollectionTimes));
+
+	TSharedRef<FJsonObject> Actors = MakeShared<FJsonObject>();
+	int32 TotalSpawned = 0;
+	TSharedRef<FJsonObject> SpawnedPerClass = MakeShared<FJsonObject>();
+	for (const TPair<FName, int32>& Pair : this->SpawnedActorsPerClass) {
+		SpawnedPerClass->SetNumberField(Pair.Key.ToString(), Pair.Value);
+		TotalSpawned += Pair.Value;
+	}
+	Actors->SetNumberField(TEXT("Alive"), World->GetActorCount());
+	Actors->SetNumberField(TEXT("Spawned"), TotalSpawned);
+	Actors->SetObjectField(TEXT("SpawnedPerClass"), SpawnedPerClass);
+	Report->SetObjectField(TEXT("Actors"), Actors);
+
+	TArray<TSharedPtr<FJsonValue>> Connections;
+	if (const UNetDriver* NetDriver = World->GetNetDriver()) {
+		for (const UNetConnection* Connection : NetDriver->ClientConnections) {
+			if (Connection == nullptr) {
+				continue;
+			}
+
+			const FString Address = Connection->LowLevelGetRemoteAddress(true);
+			const TPair<uint64, uint64>* StartBytes = this->StartBytesPerConnection.Find(Address);
+			const uint64 InBytes = Connection->InTotalBytes - (StartBytes != nullptr ? StartBytes->Key : 0);
+			const uint64 OutBytes = Connection->OutTotalBytes - (StartBytes != nullptr ? StartBytes->Value : 0);
+
+			TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+			Entry->SetStringField(TEXT("Address"), Address);
+			Entry->SetNumberField(TEXT("InBytes"), InBytes);
+			Entry->SetNumberField(TEXT("OutBytes"), OutBytes);
+			Entry->SetNumberField(TEXT("InBytesPerSecond"), InBytes / this->BenchmarkDuration);
+			Entry->SetNumberField(TEXT("OutBytesPerSecond"), OutBytes / this->BenchmarkDuration);
+			Connections.Add(MakeShared<FJsonValueObject>(Entry));
+		}
+	}
+	Report->SetArrayField(TEXT("Connections"), Connections);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	FString Path = this->ReportFileName;
+	if (FPaths::IsRelative(Path)) {
+		Path = FPaths::Combine(FPaths::ProfilingDir(), TEXT("Benchmarks"), Path);
+	}
+
+	if (FFileHelper::SaveStringToFile(Json, *Path)) {
+		UE_LOG(LogNeuroStrike, Display, TEXT("Benchmark report written to %s"), *Path);
+	} else {
+		UE_LOG(LogNeuroStrike, Error, TEXT("Failed to write benchmark report to %s"), *Path);
+	}
+}
+
+void ANeuroStrikeBenchmarkGameMode::OnActorSpawned(AActor* Actor) {
+	if (Actor != nullptr) {
+		++this->SpawnedActorsPerClass.FindOrAdd(Actor->GetClass()->GetFName());
+	}
+}
+
+void ANeuroStrikeBenchmarkGameMode::OnPreGarbageCollect() {
+	this->GarbageCollectionStartTime = FPlatformTime::Seconds();
+}
+
+void ANeuroStrikeBenchmarkGameMode::OnPostGarbageCollect() {
+	if (this->GarbageCollectionStartTime > 0.0) {
+		this->GarbageCollectionTimes.Add((FPlatformTime::Seconds() - this->GarbageCollectionStartTime) * 1000.0);
+		this->GarbageCollectionStartTime = 0.0;
+	}
+}
@@ -0,0 +1,123 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NeuroStrikeGameMode.h"
+#include "NeuroStrikeBenchmarkGameMode.generated.h"
+
+class ANeuroStrikeBotController;
+
+/**
+ * Game mode that loads the match with bots for a fixed time and writes a performance report.
+ *
+ * Every bot is an ANeuroStrikeCharacter possessed by an ANeuroStrikeBotController, which keeps moving, sprinting
+ * and firing through the regular input handlers. Once the run ends, frame time percentiles, game and render
+ * thread times, spawned-actor counts, garbage collection pauses and per-connection network traffic are written
+ * as JSON to Saved/Profiling/Benchmarks.
+ *
+ * The defaults can be overridden through URL options, so a headless run can be started with e.g.
+ * `NeuroStrikeServer /Game/FirstPerson/Maps/FirstPersonMap?game=/Script/NeuroStrike.NeuroStrikeBenchmarkGameMode
+ * ?Bots=64?Duration=120?Warmup=10?Report=Run.json?Exit=1 -nullrhi -unattended`.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API ANeuroStrikeBenchmarkGameMode : public ANeuroStrikeGameMode {
+	GENERATED_BODY()
+
+public:
+	ANeuroStrikeBenchmarkGameMode();
+
+	/** Reads the benchmark URL options. */
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	/** Spawns the bots and starts the warmup. */
+	virtual void StartPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Samples the frame once the warmup is over, and ends the run after its duration. */
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Spawns bots as the bot pawn class and players as the regular player pawn class. */
+	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
+
+	/** Number of bots spawned at the start. Overridden by the `Bots` URL option. */
+	UPROPERTY(config, EditDefaultsOnly, Category=Benchmark, meta=(ClampMin="0"))
+	int32 NumBots = 32;
+
+	/** Seconds between spawning the bots and starting to measure. Overridden by the `Warmup` URL option. */
+	UPROPERTY(config, EditDefaultsOnly, Category=Benchmark, meta=(ClampMin="0"))
+	float WarmupDuration = 5.0f;
+
+	/** Seconds during which frames are measured. Overridden by the `Duration` URL option. */
+	UPROPERTY(config, EditDefaultsOnly, Category=Benchmark, meta=(ClampMin="1"))
+	float BenchmarkDuration = 60.0f;
+
+	/** Whether the process exits once the report has been written. Overridden by the `Exit` URL option. */
+	UPROPERTY(config, EditDefaultsOnly, Category=Benchmark)
+	bool bExitWhenDone = false;
+
+	/** Pawn class spawned for bots. Falls back to the player pawn class if unset. */
+	UPROPERTY(config, EditDefaultsOnly, Category=Benchmark)
+	TSoftClassPtr<APawn> BotPawnClass;
+
+	/** Pickup actor whose weapon component is attached to every bot. */
+	UPROPERTY(config, EditDefaultsOnly, Category=Benchmark)
+	TSoftClassPtr<AActor> BotWeaponClass;
+
+	/** Controller class possessing the bots. */
+	UPROPERTY(EditDefaultsOnly, Category=Benchmark)
+	TSubclassOf<ANeuroStrikeBotController> BotControllerClass;
+
+private:
+	/** Spawns a bot and its weapon. */
+	void SpawnBot();
+
+	/** Gives a spawned bot its weapon. */
+	void ArmBot(APawn* Pawn) const;
+
+	/** Stops measuring and writes the report. */
+	void FinishBenchmark();
+
+	/** Writes the collected samples to the report file. */
+	void WriteReport() const;
+
+	void OnActorSpawned(AActor* Actor);
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	/** Report file name, relative to Saved/Profiling/Benchmarks unless absolute. Set by the `Report` URL option. */
+	FString ReportFileName;
+
+	/** Bot controllers spawned by this game mode. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ANeuroStrikeBotController>> Bots;
+
+	/** Frame, game thread and render thread times of every measured frame, in milliseconds. */
+	TArray<float> FrameTimes;
+	TArray<float> GameThreadTimes;
+	TArray<float> RenderThreadTimes;
+
+	/** Duration of every garbage collection during the measurement, in milliseconds. */
+	TArray<float> GarbageCollectionTimes;
+
+	/** Actor spawns during the measurement, per class. */
+	TMap<FName, int32> SpawnedActorsPerClass;
+
+	/** Network traffic of each client connection when the measurement started, to report the difference. */
+	TMap<FString, TPair<uint64, uint64>> StartBytesPerConnection;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+
+	/** Platform time at which the current garbage collection started. */
+	double GarbageCollectionStartTime = 0.0;
+
+	/** World time at which the measurement starts and ends. */
+	float MeasureStartTime = 0.0f;
+	float MeasureEndTime = 0.0f;
+
+	bool bMeasuring = false;
+	bool bFinished = false;
+};
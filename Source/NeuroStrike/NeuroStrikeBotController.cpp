@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeBotController.h"
+#include "NeuroStrikeCharacter.h"
+#include "InputActionValue.h"
+#include "TP_WeaponComponent.h"
+
+ANeuroStrikeBotController::ANeuroStrikeBotController() {
+	this->PrimaryActorTick.bCanEverTick = true;
+	this->bWantsPlayerState = true;
+}
+
+void ANeuroStrikeBotController::OnPossess(APawn* InPawn) {
+	Super::OnPossess(InPawn);
+
+	this->BotCharacter = Cast<ANeuroStrikeCharacter>(InPawn);
+	this->TimeUntilNextAction = 0.0f;
+	this->TriggerHeldTime = 0.0f;
+}
+
+void ANeuroStrikeBotController::Tick(float DeltaSeconds) {
+	Super::Tick(DeltaSeconds);
+
+	ANeuroStrikeCharacter* Character = this->BotCharacter.Get();
+	if (Character == nullptr || Character->IsDead()) {
+		return;
+	}
+
+	this->TimeUntilNextAction -= DeltaSeconds;
+	if (this->TimeUntilNextAction <= 0.0f) {
+		this->ChooseNextAction();
+	}
+
+	// Look input only reaches player controllers, so bots turn by setting their control rotation directly.
+	this->SetControlRotation(FMath::RInterpTo(this->GetControlRotation(), this->AimRotation, DeltaSeconds, 5.0f));
+	Character->Move(FInputActionValue(this->MoveInput));
+
+	const UTP_WeaponComponent* Weapon = Character->WeaponComponent;
+	if (Weapon == nullptr) {
+		return;
+	}
+
+	if (Weapon->GetStats().FireMode == ENeuroStrikeFireMode::Auto && Weapon->IsFiring()) {
+		this->TriggerHeldTime += DeltaSeconds;
+		if (this->TriggerHeldTime >= this->TriggerHoldTime) {
+			Character->StopFire(FInputActionValue(false));
+		}
+		return;
+	}
+
+	// Fire ignores presses the cadence does not allow yet, so pressing every frame fires at the weapon's rate.
+	this->TriggerHeldTime = 0.0f;
+	Character->Fire(FInputActionValue(true));
+}
+
+void ANeuroStrikeBotController::ChooseNextAction() {
+	ANeuroStrikeCharacter* Character = this->BotCharacter.Get();
+
+	this->TimeUntilNextAction = this->DirectionChangeInterval * FMath::FRandRange(0.5f, 1.5f);
+	this->MoveInput = FVector2D(FMath::FRandRange(-1.0f, 1.0f), FMath::FRandRange(0.25f, 1.0f)).GetSafeNormal();
+	this->AimRotation = FRotator(FMath::FRandRange(-10.0f, 10.0f), FMath::FRandRange(-180.0f, 180.0f), 0.0f);
+
+	if (FMath::FRand() < this->SprintChance) {
+		Character->Sprint(FInputActionValue(true));
+	} else {
+		Character->StopSprinting();
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "NeuroStrikeBotController.generated.h"
+
+class ANeuroStrikeCharacter;
+
+/**
+ * AI controller that plays a NeuroStrike character through the same Move, Sprint and Fire handlers as a player.
+ *
+ * Used by the benchmark game mode to load the server with realistic traffic: bots wander in random directions,
+ * sprint on and off, turn towards a random heading and keep pulling the trigger, so every per-frame and per-shot
+ * path of the character and its weapon runs exactly as it does for humans.
+ */
+UCLASS()
+class NEUROSTRIKE_API ANeuroStrikeBotController : public AAIController {
+	GENERATED_BODY()
+
+public:
+	ANeuroStrikeBotController();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Seconds between two changes of the movement direction. */
+	UPROPERTY(EditDefaultsOnly, Category=Bot, meta=(ClampMin="0.1"))
+	float DirectionChangeInterval = 2.0f;
+
+	/** Chance of sprinting after each direction change, between 0 and 1. */
+	UPROPERTY(EditDefaultsOnly, Category=Bot, meta=(ClampMin="0", ClampMax="1"))
+	float SprintChance = 0.5f;
+
+	/** Seconds an automatic weapon is held down before the trigger is released again. */
+	UPROPERTY(EditDefaultsOnly, Category=Bot, meta=(ClampMin="0"))
+	float TriggerHoldTime = 0.75f;
+
+protected:
+	virtual void OnPossess(APawn* InPawn) override;
+
+private:
+	/** Picks a new movement direction, heading and sprint state. */
+	void ChooseNextAction();
+
+	/** Character currently possessed, if it is a NeuroStrike character. */
+	TWeakObjectPtr<ANeuroStrikeCharacter> BotCharacter;
+
+	/** Movement input applied every frame until the next direction change. */
+	FVector2D MoveInput = FVector2D::ZeroVector;
+
+	/** Heading the bot aims at until the next direction change. */
+	FRotator AimRotation = FRotator::ZeroRotator;
+
+	/** Time left until the next direction change. */
+	float TimeUntilNextAction = 0.0f;
+
+	/** Time the trigger has been held since it was last pulled. */
+	float TriggerHeldTime = 0.0f;
+};
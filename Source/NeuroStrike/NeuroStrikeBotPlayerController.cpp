@@ -0,0 +1,262 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeBotPlayerController.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "NeuroStrikeMovementComponent.h"
+#include "EnhancedInputSubsystems.h"
+#include "InputActionValue.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/InputSettings.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+namespace NeuroStrikeBots {
+	static FAutoConsoleCommandWithWorld ReportCommand(
+		TEXT("NeuroStrike.Bots.Report"),
+		TEXT("Logs round-trip time, corrections and RPC rates of every bot client in the current world."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World) {
+			if (World == nullptr) {
+				return;
+			}
+
+			for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It) {
+				ANeuroStrikeBotPlayerController* Bot = Cast<ANeuroStrikeBotPlayerController>(It->Get());
+				if (Bot != nullptr && Bot->IsLocalController()) {
+					Bot->LogReport();
+				}
+			}
+		}));
+}
+
+ANeuroStrikeBotPlayerController::ANeuroStrikeBotPlayerController() {
+	FNeuroStrikeBotProfile& Wanderer = this->Profiles.AddDefaulted_GetRef();
+	Wanderer.Name = TEXT("Wanderer");
+
+	FNeuroStrikeBotProfile& Skirmisher = this->Profiles.AddDefaulted_GetRef();
+	Skirmisher.Name = TEXT("Skirmisher");
+	Skirmisher.DirectionChangeInterval = 0.75f;
+	Skirmisher.SprintChance = 0.8f;
+	Skirmisher.TurnRate = 360.0f;
+	Skirmisher.TriggerHoldTime = 1.5f;
+	Skirmisher.TriggerReleaseTime = 0.25f;
+
+	FNeuroStrikeBotProfile& Camper = this->Profiles.AddDefaulted_GetRef();
+	Camper.Name = TEXT("Camper");
+	Camper.DirectionChangeInterval = 5.0f;
+	Camper.SprintChance = 0.0f;
+	Camper.TurnRate = 90.0f;
+	Camper.TriggerHoldTime = 0.2f;
+	Camper.TriggerReleaseTime = 1.0f;
+}
+
+void ANeuroStrikeBotPlayerController::ReceivedPlayer() {
+	Super::ReceivedPlayer();
+
+	if (!this->IsLocalController() || this->ProfileIndex != INDEX_NONE || this->Profiles.IsEmpty()) {
+		return;
+	}
+
+	FString ProfileName;
+	if (FParse::Value(FCommandLine::Get(), TEXT("NeuroStrikeBotProfile="), ProfileName)) {
+		this->ProfileIndex = this->Profiles.IndexOfByPredicate([&ProfileName](const FNeuroStrikeBotProfile& Profile) {
+			return Profile.Name == FName(*ProfileName);
+		});
+		if (this->ProfileIndex == INDEX_NONE) {
+			UE_LOG(LogNeuroStrike, Warning, TEXT("Unknown bot profile %s, picking one at random"), *ProfileName);
+		}
+	}
+	if (this->ProfileIndex == INDEX_NONE) {
+		this->ProfileIndex = FMath::RandHelper(this->Profiles.Num());
+	}
+
+	this->LastReportTime = FPlatformTime::Seconds();
+
+	if (!this->IsPrimaryPlayer()) {
+		return;
+	}
+
+	if (FApp::CanEverRender()) {
+		UE_LOG(LogNeuroStrike, Warning, TEXT("Bot client is rendering; start it with -nullrhi -nosound"));
+	}
+
+	UWorld* World = GetWorld();
+	for (TActorIterator<ACharacter> It(World); It; ++It) {
+		StripAnimation(*It);
+	}
+	this->ActorSpawnedHandle = World->AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateStatic(&ANeuroStrikeBotPlayerController::StripAnimation));
+
+	int32 NumBots = 1;
+	FParse::Value(FCommandLine::Get(), TEXT("NeuroStrikeBots="), NumBots);
+	this->SpawnSiblingBots(NumBots - 1);
+}
+
+void ANeuroStrikeBotPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (this->IsLocalController() && this->ProfileIndex != INDEX_NONE) {
+		this->LogReport();
+	}
+
+	if (this->ActorSpawnedHandle.IsValid()) {
+		GetWorld()->RemoveOnActorSpawnedHandler(this->ActorSpawnedHandle);
+		this->ActorSpawnedHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ANeuroStrikeBotPlayerController::SpawnSiblingBots(int32 Count) {
+	if (Count <= 0) {
+		return;
+	}
+
+	UGameInstance* GameInstance = GetGameInstance();
+	if (UGameViewportClient* ViewportClient = GameInstance->GetGameViewportClient()) {
+		ViewportClient->MaxSplitscreenPlayers = FMath::Max(ViewportClient->MaxSplitscreenPlayers, Count + 1);
+		ViewportClient->SetForceDisableSplitscreen(true);
+	}
+
+	for (int32 Index = 0; Index < Count; ++Index) {
+		FString Error;
+		ULocalPlayer* NewPlayer = GameInstance->CreateLocalPlayer(-1, Error, false);
+		if (NewPlayer == nullptr) {
+			UE_LOG(LogNeuroStrike, Error, TEXT("Could not add bot %d of %d: %s"), Index + 2, Count + 1, *Error);
+			return;
+		}
+
+		TArray<FString> Options = {TEXT("Bot"), FString::Printf(TEXT("Name=Bot%d"), Index + 2)};
+		NewPlayer->SendSplitJoin(Options);
+	}
+
+	UE_LOG(LogNeuroStrike, Log, TEXT("Added %d bots to the connection"), Count);
+}
+
+void ANeuroStrikeBotPlayerController::PlayerTick(float DeltaTime) {
+	const ANeuroStrikeCharacter* Character = Cast<ANeuroStrikeCharacter>(this->GetPawn());
+	if (Character != nullptr && !Character->IsDead() && this->Profiles.IsValidIndex(this->ProfileIndex)) {
+		this->InjectInput(Character, DeltaTime);
+	} else {
+		// Input is no longer injected, so held actions complete on their own.
+		this->bSprintHeld = false;
+		this->bTriggerHeld = false;
+	}
+
+	Super::PlayerTick(DeltaTime);
+
+	if (this->ReportInterval > 0.0f && FPlatformTime::Seconds() - this->LastReportTime >= this->ReportInterval) {
+		this->LogReport();
+	}
+}
+
+void ANeuroStrikeBotPlayerController::InjectInput(const ANeuroStrikeCharacter* Character, float DeltaTime) {
+	UEnhancedInputLocalPlayerSubsystem* Input = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(
+		this->GetLocalPlayer());
+	if (Input == nullptr) {
+		return;
+	}
+
+	const FNeuroStrikeBotProfile& Profile = this->Profiles[this->ProfileIndex];
+
+	this->TimeUntilNextAction -= DeltaTime;
+	if (this->TimeUntilNextAction <= 0.0f) {
+		this->ChooseNextAction(Profile);
+	}
+
+	// Injected values only last one frame, so held actions are injected every frame and released by omission.
+	Input->InjectInputForAction(Character->MoveAction, FInputActionValue(this->MoveInput));
+
+	const FRotator ControlRotation = this->GetControlRotation();
+	const float MaxTurn = Profile.TurnRate * DeltaTime;
+	const float YawTurn = FMath::Clamp(FRotator::NormalizeAxis(this->AimRotation.Yaw - ControlRotation.Yaw),
+	                                   -MaxTurn, MaxTurn);
+	const float PitchTurn = FMath::Clamp(FRotator::NormalizeAxis(this->AimRotation.Pitch - ControlRotation.Pitch),
+	                                     -MaxTurn, MaxTurn);
+
+	// Look reaches AddYawInput and AddPitchInput, which multiply by the legacy input scales when they are enabled.
+	// Injected values skip the mapping modifiers, so dividing by the scales alone turns by exactly these degrees.
+	const bool bLegacyScales = GetDefault<UInputSettings>()->bEnableLegacyInputScales;
+	const float YawScale = bLegacyScales ? this->GetDeprecatedInputYawScale() : 1.0f;
+	const float PitchScale = bLegacyScales ? this->GetDeprecatedInputPitchScale() : 1.0f;
+	const FVector2D LookInput(FMath::IsNearlyZero(YawScale) ? 0.0f : YawTurn / YawScale,
+	                          FMath::IsNearlyZero(PitchScale) ? 0.0f : PitchTurn / PitchScale);
+	if (!LookInput.IsNearlyZero()) {
+		Input->InjectInputForAction(Character->LookAction, FInputActionValue(LookInput));
+	}
+
+	if (this->bSprintHeld) {
+		Input->InjectInputForAction(Character->SprintAction, FInputActionValue(true));
+	}
+
+	this->TimeUntilTriggerToggle -= DeltaTime;
+	if (this->TimeUntilTriggerToggle <= 0.0f) {
+		this->bTriggerHeld = !this->bTriggerHeld;
+		this->TimeUntilTriggerToggle = this->bTriggerHeld ? Profile.TriggerHoldTime : Profile.TriggerReleaseTime;
+	}
+	if (this->bTriggerHeld) {
+		Input->InjectInputForAction(Character->FireAction, FInputActionValue(true));
+	}
+}
+
+void ANeuroStrikeBotPlayerController::ChooseNextAction(const FNeuroStrikeBotProfile& Profile) {
+	this->TimeUntilNextAction = Profile.DirectionChangeInterval * FMath::FRandRange(0.5f, 1.5f);
+	this->MoveInput = FVector2D(FMath::FRandRange(-1.0f, 1.0f), FMath::FRandRange(0.25f, 1.0f)).GetSafeNormal();
+	this->AimRotation = FRotator(FMath::FRandRange(-10.0f, 10.0f), FMath::FRandRange(-180.0f, 180.0f), 0.0f);
+	this->bSprintHeld = FMath::FRand() < Profile.SprintChance;
+}
+
+void ANeuroStrikeBotPlayerController::LogReport() {
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = FMath::Max(Now - this->LastReportTime, UE_SMALL_NUMBER);
+	this->LastReportTime = Now;
+
+	const ANeuroStrikeCharacter* Character = Cast<ANeuroStrikeCharacter>(this->GetPawn());
+	const UNeuroStrikeMovementComponent* Movement = Character != nullptr
+		                                                ? Character->GetNeuroStrikeMovement()
+		                                                : nullptr;
+	const int32 Corrections = Movement != nullptr ? Movement->GetNumCorrections() : 0;
+	const int32 ServerMoves = Movement != nullptr ? Movement->GetNumServerMoves() : 0;
+	const int32 ServerRpcs = this->GetServerRpcsSent();
+
+	// Movement counters restart with a new pawn.
+	const int32 NewCorrections = Corrections >= this->LastReportCorrections
+		                             ? Corrections - this->LastReportCorrections
+		                             : Corrections;
+	const int32 NewServerMoves = ServerMoves >= this->LastReportServerMoves
+		                             ? ServerMoves - this->LastReportServerMoves
+		                             : ServerMoves;
+	const int32 NewServerRpcs = ServerRpcs - this->LastReportServerRpcs;
+	this->LastReportCorrections = Corrections;
+	this->LastReportServerMoves = ServerMoves;
+	this->LastReportServerRpcs = ServerRpcs;
+
+	const FString BotName = this->PlayerState != nullptr ? this->PlayerState->GetPlayerName() : GetName();
+	const FName ProfileName = this->Profiles.IsValidIndex(this->ProfileIndex)
+		                          ? this->Profiles[this->ProfileIndex].Name
+		                          : NAME_None;
+	UE_LOG(LogNeuroStrike, Log,
+	       TEXT("Bot %s (%s): rtt %.0f ms, %d corrections (%.2f/s), %.1f moves/s, %.1f other RPCs/s"),
+	       *BotName, *ProfileName.ToString(),
+	       this->PlayerState != nullptr ? this->PlayerState->GetPingInMilliseconds() : 0.0f,
+	       NewCorrections, NewCorrections / Elapsed, NewServerMoves / Elapsed, NewServerRpcs / Elapsed);
+}
+
+void ANeuroStrikeBotPlayerController::StripAnimation(AActor* Actor) {
+	const ACharacter* Character = Cast<ACharacter>(Actor);
+	if (Character == nullptr) {
+		return;
+	}
+
+	TInlineComponentArray<USkeletalMeshComponent*> Meshes(Actor);
+	for (USkeletalMeshComponent* Mesh : Meshes) {
+		// Nothing renders in a bot process, so this never evaluates poses nor refreshes bones.
+		Mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	}
+}
@@ -0,0 +1,152 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NeuroStrikePlayerController.h"
+#include "NeuroStrikeBotPlayerController.generated.h"
+
+class ANeuroStrikeCharacter;
+
+/**
+ * Scripted behaviour of a bot client.
+ */
+USTRUCT()
+struct FNeuroStrikeBotProfile {
+	GENERATED_BODY()
+
+	/** Name selecting the profile with -NeuroStrikeBotProfile=. */
+	UPROPERTY()
+	FName Name;
+
+	/** Seconds between two changes of the movement direction and heading. */
+	UPROPERTY()
+	float DirectionChangeInterval = 2.0f;
+
+	/** Chance of sprinting after each direction change, between 0 and 1. */
+	UPROPERTY()
+	float SprintChance = 0.5f;
+
+	/** Fastest the bot turns towards its heading, in degrees per second. */
+	UPROPERTY()
+	float TurnRate = 180.0f;
+
+	/** Seconds the trigger is held down on each pull. */
+	UPROPERTY()
+	float TriggerHoldTime = 0.75f;
+
+	/** Seconds the trigger stays released between two pulls. */
+	UPROPERTY()
+	float TriggerReleaseTime = 0.5f;
+};
+
+/**
+ * Player controller of headless bot clients, used to load test dedicated servers.
+ *
+ * Bot clients are regular game clients started with -nullrhi -nosound that join with the Bot URL option, for which
+ * the game mode spawns this controller instead of the player one. Instead of reading devices, it injects synthetic
+ * values into the character's own input actions, so Move, Look, Sprint and Fire run through Enhanced Input and
+ * every client-side and RPC path exactly as for humans. The behaviour comes from a scripted profile.
+ *
+ * A single process runs -NeuroStrikeBots=N bots: the first one adds the others as split-screen players of its
+ * connection, so bots share the world, the assets and the socket of the process. Skeletal meshes of every character
+ * in it stop evaluating poses. Each bot periodically logs its round-trip time, movement corrections and RPC rates.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API ANeuroStrikeBotPlayerController : public ANeuroStrikePlayerController {
+	GENERATED_BODY()
+
+public:
+	ANeuroStrikeBotPlayerController();
+
+	/**
+	 * Injects this frame's synthetic input before the player input is processed.
+	 */
+	virtual void PlayerTick(float DeltaTime) override;
+
+	/**
+	 * Picks the bot's profile and, for the first bot of the process, adds the other bots.
+	 */
+	virtual void ReceivedPlayer() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/**
+	 * Logs the bot's round-trip time, corrections and RPC rates since the previous report.
+	 */
+	void LogReport();
+
+	/** Behaviour profiles bots pick from, at random unless -NeuroStrikeBotProfile= names one. */
+	UPROPERTY(config)
+	TArray<FNeuroStrikeBotProfile> Profiles;
+
+	/** Seconds between two reports of each bot. Zero only reports when the bot leaves. */
+	UPROPERTY(config)
+	float ReportInterval = 10.0f;
+
+private:
+	/**
+	 * Adds split-screen bots to the connection of this one.
+	 *
+	 * @param Count Number of bots to add.
+	 */
+	void SpawnSiblingBots(int32 Count);
+
+	/**
+	 * Picks a new movement direction, heading and sprint state.
+	 *
+	 * @param Profile Profile of the bot.
+	 */
+	void ChooseNextAction(const FNeuroStrikeBotProfile& Profile);
+
+	/**
+	 * Feeds the character's input actions with this frame's values.
+	 *
+	 * @param Character The possessed character.
+	 * @param DeltaTime Time since the previous frame.
+	 */
+	void InjectInput(const ANeuroStrikeCharacter* Character, float DeltaTime);
+
+	/**
+	 * Stops pose evaluation of a character's skeletal meshes, which nobody ever sees in a bot process.
+	 *
+	 * @param Actor The spawned actor, ignored if it is not a character.
+	 */
+	static void StripAnimation(AActor* Actor);
+
+	/** Index of the bot's profile in Profiles. */
+	int32 ProfileIndex = INDEX_NONE;
+
+	/** Movement input injected every frame until the next direction change. */
+	FVector2D MoveInput = FVector2D::ZeroVector;
+
+	/** Heading the bot turns to until the next direction change. */
+	FRotator AimRotation = FRotator::ZeroRotator;
+
+	/** Time left until the next direction change. */
+	float TimeUntilNextAction = 0.0f;
+
+	/** Time left until the trigger is next pulled or released. */
+	float TimeUntilTriggerToggle = 0.0f;
+
+	/** Whether the sprint action is held. */
+	bool bSprintHeld = false;
+
+	/** Whether the fire action is held. */
+	bool bTriggerHeld = false;
+
+	/** Real time of the previous report. */
+	double LastReportTime = 0.0;
+
+	/** Movement corrections counted at the previous report. */
+	int32 LastReportCorrections = 0;
+
+	/** Movement RPCs counted at the previous report. */
+	int32 LastReportServerMoves = 0;
+
+	/** Other server RPCs counted at the previous report. */
+	int32 LastReportServerRpcs = 0;
+
+	/** Spawn handler stripping animation from characters, registered by the first bot of the process. */
+	FDelegateHandle ActorSpawnedHandle;
+};
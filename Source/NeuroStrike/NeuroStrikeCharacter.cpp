@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "NeuroStrikeCharacter.h"
+#include "NeuroStrike.h"
 #include "Animation/AnimInstance.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
@@ -8,43 +9,160 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "NeuroStrikeDamageSubsystem.h"
+#include "NeuroStrikeFirstPersonMeshComponent.h"
+#include "NeuroStrikeGameMode.h"
+#include "NeuroStrikeLagCompensationSubsystem.h"
+#include "NeuroStrikeLatencySubsystem.h"
+#include "NeuroStrikeMatchRecorderSubsystem.h"
+#include "NeuroStrikeMovementComponent.h"
+#include "NeuroStrikePlayerController.h"
+#include "NeuroStrikeReplicationGraph.h"
+#include "NeuroStrikeTombSubsystem.h"
+#include "SkeletalMeshComponentBudgeted.h"
 #include "TP_WeaponComponent.h"
 #include "Engine/LocalPlayer.h"
-#include "Engine/StaticMeshActor.h"
 #include "UObject/ConstructorHelpers.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/SoftObjectPath.h"
 
-class AStaticMeshActor;
 class UNiagaraSystem;
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 
-ANeuroStrikeCharacter::ANeuroStrikeCharacter() {
+#if NEUROSTRIKE_WITH_DEBUG_OVERLAY
+namespace NeuroStrikeDebug {
+	static int32 ShowVitals = 0;
+
+	static void OnShowVitalsChanged(IConsoleVariable* Variable) {
+		for (const FWorldContext& Context : GEngine->GetWorldContexts()) {
+			if (UWorld* World = Context.World()) {
+				for (TActorIterator<ANeuroStrikeCharacter> It(World); It; ++It) {
+					It->UpdateDebugOverlay();
+				}
+			}
+		}
+	}
+
+	static FAutoConsoleVariableRef CVarShowVitals(
+		TEXT("NeuroStrike.Debug.ShowVitals"),
+		ShowVitals,
+		TEXT("Shows the health and stamina of every character on screen. Refreshed on change, not every frame."),
+		FConsoleVariableDelegate::CreateStatic(&OnShowVitalsChanged));
+}
+#endif
+
+bool FNeuroStrikeMovementState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+	Ar << this->Health;
+
+	uint8 Flags = this->bIsSprinting ? 1 : 0;
+	Ar.SerializeBits(&Flags, 1);
+	this->bIsSprinting = (Flags & 1) != 0;
+
+	bOutSuccess = true;
+	return true;
+}
+
+uint8 FNeuroStrikeMovementState::Quantize(float Value, float Max) {
+	if (Max <= 0.0f) {
+		return 0;
+	}
+
+	return static_cast<uint8>(FMath::RoundToInt(FMath::Clamp(Value / Max, 0.0f, 1.0f) * 255.0f));
+}
+
+float FNeuroStrikeMovementState::Dequantize(uint8 Quantized, float Max) {
+	return Quantized / 255.0f * Max;
+}
+
+void FNeuroStrikeQuantizedAim::Set(const FRotator& Rotation) {
+	this->Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+	this->Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+}
+
+FRotator FNeuroStrikeQuantizedAim::Get() const {
+	return FRotator(FRotator::DecompressAxisFromShort(this->Pitch), FRotator::DecompressAxisFromShort(this->Yaw),
+	                0.0f);
+}
+
+ANeuroStrikeCharacter::ANeuroStrikeCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UNeuroStrikeMovementComponent>(
+		                         ACharacter::CharacterMovementComponentName)
+	                         .SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(
+		                         ACharacter::MeshComponentName)) {
+	// Stamina is evaluated lazily, so nothing requires a per-frame actor tick.
+	this->PrimaryActorTick.bStartWithTickEnabled = false;
+
 	this->bHasRifle = false;
 
 	this->GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
+	// Projectiles stop at the capsule, so they never sweep against the shapes of the character meshes.
+	this->GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_NeuroStrikeProjectile, ECR_Block);
+	this->GetMesh()->SetCollisionResponseToChannel(ECC_NeuroStrikeProjectile, ECR_Ignore);
 
 	this->FirstPersonCameraComponent = this->CreateDefaultSubobject<UCameraComponent>("FirstPersonCamera");
 	this->FirstPersonCameraComponent->SetupAttachment(GetCapsuleComponent());
 	this->FirstPersonCameraComponent->SetRelativeLocation(FVector(-10.f, 0.f, 60.f));
 	this->FirstPersonCameraComponent->bUsePawnControlRotation = true;
 
-	this->Mesh1P = this->CreateDefaultSubobject<USkeletalMeshComponent>("CharacterMesh1P");
-	this->Mesh1P->SetOnlyOwnerSee(true);
-	this->Mesh1P->SetupAttachment(this->FirstPersonCameraComponent);
-	this->Mesh1P->bCastDynamicShadow = false;
-	this->Mesh1P->CastShadow = false;
-	this->Mesh1P->SetRelativeLocation(FVector(-30.f, 0.f, -150.f));
+	// Nobody ever sees the first-person arms on a dedicated server, so it never creates them.
+	if (!IsRunningDedicatedServer()) {
+		this->Mesh1P = this->CreateOptionalDefaultSubobject<UNeuroStrikeFirstPersonMeshComponent>("CharacterMesh1P");
+		this->Mesh1P->SetOnlyOwnerSee(true);
+		this->Mesh1P->SetupAttachment(this->FirstPersonCameraComponent);
+		this->Mesh1P->bCastDynamicShadow = false;
+		this->Mesh1P->CastShadow = false;
+		this->Mesh1P->SetRelativeLocation(FVector(-30.f, 0.f, -150.f));
+
+		// Only the owner ever sees the first-person arms, so their poses are only evaluated when rendered.
+		this->Mesh1P->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	}
+
+	// Only other players see the body, so its poses are only evaluated when rendered. It keeps advancing montages
+	// so they stay in sync when it becomes visible.
+	this->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	this->GetMesh()->bEnableUpdateRateOptimizations = true;
+}
+
+void ANeuroStrikeCharacter::Serialize(FArchive& Ar) {
+#if WITH_EDITOR
+	// Paths are still saved, only the assets behind them are not cooked along.
+	TOptional<FSoftObjectPathSerializationScope> ServerCookScope;
+	if (NeuroStrikeCook::IsCookingForServer(Ar)) {
+		ServerCookScope.Emplace(ESoftObjectPathCollectType::NeverCollect);
+	}
+#endif
+
+	Super::Serialize(Ar);
 }
 
 void ANeuroStrikeCharacter::BeginPlay() {
 	Super::BeginPlay();
 
-	this->GetCharacterMovement()->MaxWalkSpeed = this->WalkingSpeed;
+	UNeuroStrikeMovementComponent* Movement = this->GetNeuroStrikeMovement();
+	Movement->MaxWalkSpeed = this->WalkingSpeed;
+	Movement->MaxSprintSpeed = this->SprintingSpeed;
 	this->PlayerId = FMath::RandRange(1, 10000);
 	this->Health = this->MaxHealth;
-	this->BaseStamina = this->MaxStamina;
+	this->SetStamina(this->MaxStamina);
+	this->UpdateFirstPersonMeshEvaluation();
+
+	if (this->HasAuthority()) {
+		this->TransformHistory.Init(this->TransformHistoryLength);
+		if (UNeuroStrikeLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<
+			UNeuroStrikeLagCompensationSubsystem>()) {
+			LagCompensation->RegisterCharacter(this);
+		}
+
+		UNeuroStrikeReplicationGraph::SetActorNetUpdateFrequency(this, this->IdleNetUpdateFrequency);
+		this->NextNetUpdateTierTime = GetWorld()->GetTimeSeconds() + this->NetUpdateTierInterval;
+	}
 
 	if (APlayerController* PlayerController = Cast<APlayerController>(Controller)) {
 		if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<
@@ -54,25 +172,50 @@ void ANeuroStrikeCharacter::BeginPlay() {
 	}
 }
 
+void ANeuroStrikeCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (UWorld* World = GetWorld()) {
+		if (UNeuroStrikeLagCompensationSubsystem* LagCompensation = World->GetSubsystem<
+			UNeuroStrikeLagCompensationSubsystem>()) {
+			LagCompensation->UnregisterCharacter(this);
+		}
+	}
+
+#if NEUROSTRIKE_WITH_DEBUG_OVERLAY
+	if (GEngine != nullptr) {
+		GEngine->RemoveOnScreenDebugMessage(this->PlayerId);
+	}
+#endif
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ANeuroStrikeCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) {
 	if (UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(PlayerInputComponent)) {
 		EnhancedInputComponent->BindAction(this->JumpAction, ETriggerEvent::Started, this, &ACharacter::Jump);
 		EnhancedInputComponent->BindAction(this->JumpAction, ETriggerEvent::Completed, this, &ACharacter::StopJumping);
 
+		// Look and move only gather input; the player controller applies it once per frame.
 		EnhancedInputComponent->BindAction(this->MoveAction, ETriggerEvent::Triggered, this,
-		                                   &ANeuroStrikeCharacter::Move);
+		                                   &ANeuroStrikeCharacter::GatherMoveInput);
 
 		EnhancedInputComponent->BindAction(this->LookAction, ETriggerEvent::Triggered, this,
-		                                   &ANeuroStrikeCharacter::Look);
+		                                   &ANeuroStrikeCharacter::GatherLookInput);
 
 		EnhancedInputComponent->BindAction(this->FireAction, ETriggerEvent::Started, this,
 		                                   &ANeuroStrikeCharacter::Fire);
 
-		EnhancedInputComponent->BindAction(this->SprintAction, ETriggerEvent::Triggered, this,
+		EnhancedInputComponent->BindAction(this->FireAction, ETriggerEvent::Completed, this,
+		                                   &ANeuroStrikeCharacter::StopFire);
+
+		// Sprint intent only changes on press and release; the movement component handles the rest.
+		EnhancedInputComponent->BindAction(this->SprintAction, ETriggerEvent::Started, this,
 		                                   &ANeuroStrikeCharacter::Sprint);
 
 		EnhancedInputComponent->BindAction(this->SprintAction, ETriggerEvent::Completed, this,
 		                                   &ANeuroStrikeCharacter::StopSprinting);
+
+		EnhancedInputComponent->BindAction(this->SprintAction, ETriggerEvent::Canceled, this,
+		                                   &ANeuroStrikeCharacter::StopSprinting);
 	} else {
 		UE_LOG(LogTemplateCharacter, Error,
 		       TEXT(
@@ -81,50 +224,161 @@ void ANeuroStrikeCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInp
 	}
 }
 
-void ANeuroStrikeCharacter::Tick(float DeltaSeconds) {
-	Super::Tick(DeltaSeconds);
-
-	static float AccumulatedTime = 0.0f;
-	AccumulatedTime += DeltaSeconds;
-	if (AccumulatedTime >= 0.1f && this->BaseStamina < this->MaxStamina) {
-		this->BaseStamina += this->StaminaRegenRate;
+void ANeuroStrikeCharacter::Despawn() {
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Character Despawn", STAT_NeuroStrike_Despawn);
 
-		AccumulatedTime = 0.0f;
+	if (UNeuroStrikeDamageSubsystem* Damage = GetWorld()->GetSubsystem<UNeuroStrikeDamageSubsystem>()) {
+		Damage->QueueDamage(nullptr, this, this->Health, GetActorLocation());
 	}
+}
 
-	if (this->GetLocalRole() == ROLE_Authority) {
-		GEngine->AddOnScreenDebugMessage(this->PlayerId,
-		                                 5.f, FColor::Red,
-		                                 FString::Printf(TEXT("%s Health: %.1f"),
-		                                                 *GetName(),
-		                                                 this->Health
-		                                 )
-		);
+void ANeuroStrikeCharacter::ServerDespawn_Implementation() {
+	INC_DWORD_STAT(STAT_NeuroStrike_RPC_ServerDespawn);
+	if (!this->ConsumeServerRpcBudget(TEXT("ServerDespawn"))) {
+		return;
 	}
+
+	this->Despawn();
 }
 
-void ANeuroStrikeCharacter::Despawn() {
-	GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("%s is dead"), *GetName()));
+void ANeuroStrikeCharacter::NotifyFireStarted(float StartTime, uint16 FirstShotId, int32 ShotCount) {
+	if (!this->HasAuthority()) {
+		return;
+	}
 
-	this->Multicast_OnDespawnEffects();
-	this->Destroy();
+	INC_DWORD_STAT(STAT_NeuroStrike_FireStateUpdates);
+	++this->FireState.Sequence;
+	this->FireState.FirstShotId = FirstShotId;
+	this->FireState.ShotCount = ShotCount;
+	this->FireState.StartTime = StartTime;
+	this->ForceNetUpdate();
 }
 
-void ANeuroStrikeCharacter::ServerDespawn_Implementation() {
-	this->Despawn();
-}
+void ANeuroStrikeCharacter::NotifyFireStopped(int32 ShotCount) {
+	if (!this->HasAuthority() || this->FireState.ShotCount == ShotCount) {
+		return;
+	}
 
-void ANeuroStrikeCharacter::FireFX_Implementation() {
-	this->WeaponComponent->HandleProjectileFX();
+	INC_DWORD_STAT(STAT_NeuroStrike_FireStateUpdates);
+	this->FireState.ShotCount = ShotCount;
+	this->ForceNetUpdate();
 }
 
-void ANeuroStrikeCharacter::Shoot() {
+void ANeuroStrikeCharacter::OnRep_FireState(const FNeuroStrikeFireState& OldFireState) {
 	if (this->WeaponComponent == nullptr) {
 		return;
 	}
 
-	this->WeaponComponent->HandleProjectile();
-	this->FireFX();
+	if (this->FireState.Sequence != OldFireState.Sequence) {
+		const AGameStateBase* GameState = GetWorld()->GetGameState();
+		const float Age = GameState != nullptr
+			                  ? GameState->GetServerWorldTimeSeconds() - this->FireState.StartTime
+			                  : 0.0f;
+		const bool bFinished = this->FireState.ShotCount != INDEX_NONE;
+		const float Duration = bFinished ? this->FireState.ShotCount * this->WeaponComponent->GetShotInterval() : 0.0f;
+		if (bFinished && Age > Duration + this->MaxRemoteFireDelay) {
+			return;
+		}
+
+		this->WeaponComponent->StartFiring(this->FireState.StartTime, this->FireState.FirstShotId);
+	}
+
+	if (this->FireState.ShotCount != INDEX_NONE) {
+		this->WeaponComponent->LimitFiring(this->FireState.ShotCount);
+	}
+}
+
+void ANeuroStrikeCharacter::Shoot(float ShotTime, uint16 ShotId) {
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Character Shoot", STAT_NeuroStrike_Shoot);
+
+	if (this->WeaponComponent == nullptr || this->bIsDead) {
+		return;
+	}
+
+	const double HandleStartTime = FPlatformTime::Seconds();
+	this->WeaponComponent->HandleProjectile(ShotTime, ShotId);
+	const double HandleEndTime = FPlatformTime::Seconds();
+
+	// Other clients replay the shot from the replicated fire state; only a listen server plays it here.
+	if (this->GetNetMode() != NM_DedicatedServer) {
+		this->WeaponComponent->HandleProjectileFX();
+	}
+
+	if (this->HasAuthority()) {
+		if (UNeuroStrikeLatencySubsystem* Latency = GetWorld()->GetSubsystem<UNeuroStrikeLatencySubsystem>()) {
+			Latency->RecordSpan(this, ENeuroStrikeLatencySpan::ShootToSpawn, HandleEndTime - HandleStartTime);
+			if (!this->IsLocallyControlled()) {
+				Latency->RecordSpan(this, ENeuroStrikeLatencySpan::FireToShoot, GetWorld()->GetTimeSeconds() - ShotTime);
+			}
+		}
+	}
+
+	if (this->HasAuthority()) {
+		NeuroStrikeStats::RecordShot();
+		if (UNeuroStrikeMatchRecorderSubsystem* Recorder = UNeuroStrikeMatchRecorderSubsystem::GetActive(GetWorld())) {
+			Recorder->RecordShot(this, ShotId);
+		}
+		this->LastShotTime = GetWorld()->GetTimeSeconds();
+		this->ApplyNetUpdateFrequency(this->ComputeNetUpdateFrequency(this->LastShotTime));
+	}
+}
+
+float ANeuroStrikeCharacter::ComputeNetUpdateFrequency(float Time) const {
+	const bool bFiredRecently = this->LastShotTime >= 0.0f
+		&& Time - this->LastShotTime <= this->FiringNetUpdateDuration;
+	if (bFiredRecently) {
+		return this->FiringNetUpdateFrequency;
+	}
+
+	return this->GetVelocity().IsNearlyZero(1.0f) ? this->IdleNetUpdateFrequency : this->MovingNetUpdateFrequency;
+}
+
+void ANeuroStrikeCharacter::ApplyNetUpdateFrequency(float Frequency) {
+	if (Frequency > this->NetUpdateFrequency) {
+		// Do not wait for the slower tier's next update before sending the change in activity.
+		this->ForceNetUpdate();
+	}
+
+	UNeuroStrikeReplicationGraph::SetActorNetUpdateFrequency(this, Frequency);
+}
+
+float ANeuroStrikeCharacter::RunServerPhase(float Time) {
+	const UCapsuleComponent* Capsule = this->GetCapsuleComponent();
+	this->TransformHistory.Record(Time, Capsule->GetComponentLocation(), Capsule->GetComponentQuat());
+
+	if (Time < this->NextNetUpdateTierTime) {
+		return 0.0f;
+	}
+
+	const float Frequency = this->ComputeNetUpdateFrequency(Time);
+	return Frequency != this->NetUpdateFrequency ? Frequency : 0.0f;
+}
+
+void ANeuroStrikeCharacter::CommitServerPhase(float Time, float NetUpdateFrequency) {
+	if (Time >= this->NextNetUpdateTierTime) {
+		this->NextNetUpdateTierTime = Time + this->NetUpdateTierInterval;
+	}
+
+	if (NetUpdateFrequency > 0.0f) {
+		this->ApplyNetUpdateFrequency(NetUpdateFrequency);
+	}
+}
+
+bool ANeuroStrikeCharacter::GetHistoricalTransform(float Time, FVector& OutLocation, FQuat& OutRotation) const {
+	return this->TransformHistory.Sample(Time, OutLocation, OutRotation);
+}
+
+float ANeuroStrikeCharacter::GetClientShotTime() const {
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	if (GameState == nullptr) {
+		return World->GetTimeSeconds();
+	}
+
+	const float HalfRoundTrip = this->GetPlayerState() != nullptr
+		                            ? this->GetPlayerState()->GetPingInMilliseconds() * 0.0005f
+		                            : 0.0f;
+	return GameState->GetServerWorldTimeSeconds() - HalfRoundTrip;
 }
 
 void ANeuroStrikeCharacter::Move(const FInputActionValue& Value) {
@@ -145,26 +399,70 @@ void ANeuroStrikeCharacter::Look(const FInputActionValue& Value) {
 	}
 }
 
-void ANeuroStrikeCharacter::Fire(const FInputActionValue& InputActionValue) {
-	if (this->GetLocalRole() == ROLE_Authority) {
-		this->Shoot();
+void ANeuroStrikeCharacter::GatherMoveInput(const FInputActionValue& Value) {
+	if (ANeuroStrikePlayerController* PlayerController = Cast<ANeuroStrikePlayerController>(this->Controller)) {
+		PlayerController->AddMoveInput(Value.Get<FVector2D>());
 	} else {
-		this->ServerFire();
+		this->Move(Value);
 	}
 }
 
-void ANeuroStrikeCharacter::Sprint(const FInputActionValue& InputActionValue) {
-	float StaminaCost = 0.1f;
-	if (this->PlayerHasEnoughStamina(StaminaCost) && this->IsPlayerMoving()) {
-		this->GetCharacterMovement()->MaxWalkSpeed = this->SprintingSpeed;
-		this->DecreaseStamina(StaminaCost);
+void ANeuroStrikeCharacter::GatherLookInput(const FInputActionValue& Value) {
+	if (ANeuroStrikePlayerController* PlayerController = Cast<ANeuroStrikePlayerController>(this->Controller)) {
+		PlayerController->AddLookInput(Value.Get<FVector2D>());
 	} else {
-		this->StopSprinting();
+		this->Look(Value);
+	}
+}
+
+void ANeuroStrikeCharacter::ApplyFrameInput(const FNeuroStrikeFrameInput& Input) {
+	if (Input.NumMoveSamples > 0) {
+		this->Move(FInputActionValue(Input.Move));
+	}
+	if (Input.NumLookSamples > 0) {
+		this->Look(FInputActionValue(Input.Look));
 	}
 }
 
+void ANeuroStrikeCharacter::Fire(const FInputActionValue& InputActionValue) {
+	const float StartTime = this->GetShotTime();
+	if (this->WeaponComponent == nullptr || this->bIsDead || !this->WeaponComponent->CanStartFiring(StartTime)) {
+		return;
+	}
+
+	const uint16 FirstShotId = this->WeaponComponent->GetNextShotId();
+	this->WeaponComponent->StartFiring(StartTime, FirstShotId);
+	if (!this->HasAuthority()) {
+		this->ServerStartFiring(StartTime, FirstShotId);
+		this->NotifyServerRpcSent();
+	}
+}
+
+void ANeuroStrikeCharacter::StopFire(const FInputActionValue& InputActionValue) {
+	if (this->WeaponComponent == nullptr || !this->WeaponComponent->IsFiring()
+		|| this->WeaponComponent->GetStats().FireMode != ENeuroStrikeFireMode::Auto) {
+		return;
+	}
+
+	const float StopTime = this->GetShotTime();
+	const uint16 LastShotId = this->WeaponComponent->GetNextShotId() - 1;
+	this->WeaponComponent->StopFiring(StopTime, LastShotId);
+	if (!this->HasAuthority()) {
+		this->ServerStopFiring(StopTime, LastShotId);
+		this->NotifyServerRpcSent();
+	}
+}
+
+float ANeuroStrikeCharacter::GetShotTime() const {
+	return this->HasAuthority() ? GetWorld()->GetTimeSeconds() : this->GetClientShotTime();
+}
+
+void ANeuroStrikeCharacter::Sprint(const FInputActionValue& InputActionValue) {
+	this->GetNeuroStrikeMovement()->SetWantsToSprint(true);
+}
+
 void ANeuroStrikeCharacter::StopSprinting() {
-	this->GetCharacterMovement()->MaxWalkSpeed = this->WalkingSpeed;
+	this->GetNeuroStrikeMovement()->SetWantsToSprint(false);
 }
 
 bool ANeuroStrikeCharacter::IsPlayerMoving() {
@@ -180,65 +478,310 @@ bool ANeuroStrikeCharacter::GetHasRifle() {
 	return bHasRifle;
 }
 
-void ANeuroStrikeCharacter::ServerFire_Implementation() {
-	this->Shoot();
+void ANeuroStrikeCharacter::ServerStartFiring_Implementation(float StartTime, uint16 FirstShotId) {
+	INC_DWORD_STAT(STAT_NeuroStrike_RPC_ServerStartFiring);
+	if (!this->ConsumeServerRpcBudget(TEXT("ServerStartFiring"))) {
+		return;
+	}
+
+	if (UNeuroStrikeLatencySubsystem* Latency = GetWorld()->GetSubsystem<UNeuroStrikeLatencySubsystem>()) {
+		Latency->RecordSpan(this, ENeuroStrikeLatencySpan::FireToServer, GetWorld()->GetTimeSeconds() - StartTime);
+	}
+
+	// Presses from further back than the server rewinds, or from the future, are moved to the edge of the window,
+	// so a client can neither schedule shots ahead nor make the server catch up a whole magazine at once.
+	const UNeuroStrikeLagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<
+		UNeuroStrikeLagCompensationSubsystem>();
+	const float ClampedStartTime = LagCompensation != nullptr
+		                               ? LagCompensation->ClampRewindTime(StartTime)
+		                               : FMath::Min(StartTime, GetWorld()->GetTimeSeconds());
+
+	if (this->WeaponComponent != nullptr) {
+		this->WeaponComponent->StartFiring(ClampedStartTime, FirstShotId);
+	}
+}
+
+void ANeuroStrikeCharacter::ServerStopFiring_Implementation(float StopTime, uint16 LastShotId) {
+	INC_DWORD_STAT(STAT_NeuroStrike_RPC_ServerStopFiring);
+	// A dropped release of a running automatic sequence would leave the weapon firing, so only those are free.
+	// Any other stop has nothing to end and draws from the budget, so it cannot be flooded without limit.
+	if (this->WeaponComponent == nullptr || !this->WeaponComponent->IsFiring()
+		|| this->WeaponComponent->GetStats().FireMode != ENeuroStrikeFireMode::Auto) {
+		this->ConsumeServerRpcBudget(TEXT("ServerStopFiring"));
+		return;
+	}
+
+	// A release from the future would let the cadence limit allow shots the client has not had time to fire.
+	this->WeaponComponent->StopFiring(FMath::Min(StopTime, GetWorld()->GetTimeSeconds()), LastShotId);
 }
 
 bool ANeuroStrikeCharacter::PlayerHasEnoughStamina(float StaminaCost) {
-	return this->BaseStamina >= StaminaCost;
-}
-
-void ANeuroStrikeCharacter::Multicast_OnDespawnEffects_Implementation() {
-	if (this->TombMesh) {
-		FTransform SpawnTransform = GetActorTransform();
-		AStaticMeshActor* Tomb = GetWorld()->SpawnActor<AStaticMeshActor>(
-			AStaticMeshActor::StaticClass(), SpawnTransform);
-		if (Tomb) {
-			UStaticMeshComponent* MeshComp = Tomb->GetStaticMeshComponent();
-			if (MeshComp) {
-				MeshComp->SetMobility(EComponentMobility::Movable);
-				MeshComp->SetStaticMesh(TombMesh);
-			}
-		}
+	return this->GetStamina() >= StaminaCost;
+}
+
+float ANeuroStrikeCharacter::GetStamina() const {
+	const float Elapsed = GetWorld()->GetTimeSeconds() - this->StaminaChangeTime;
+	return FMath::Min(this->BaseStamina + this->StaminaRegenRate * Elapsed, this->MaxStamina);
+}
+
+void ANeuroStrikeCharacter::SetStamina(float NewStamina) {
+	this->BaseStamina = FMath::Clamp(NewStamina, 0.0f, this->MaxStamina);
+	this->StaminaChangeTime = GetWorld()->GetTimeSeconds();
+
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	if (this->BaseStamina < this->MaxStamina && this->StaminaRegenRate > 0.0f) {
+		const float TimeUntilFull = (this->MaxStamina - this->BaseStamina) / this->StaminaRegenRate;
+		TimerManager.SetTimer(this->StaminaRegenTimerHandle, this, &ANeuroStrikeCharacter::OnStaminaRegenerated,
+		                      TimeUntilFull);
+	} else {
+		TimerManager.ClearTimer(this->StaminaRegenTimerHandle);
+	}
+
+	this->RefreshReplicatedMovementState();
+	this->UpdateDebugOverlay();
+}
+
+void ANeuroStrikeCharacter::OnStaminaRegenerated() {
+	this->SetStamina(this->MaxStamina);
+}
+
+void ANeuroStrikeCharacter::SpawnTomb() {
+	if (!this->HasAuthority()) {
+		return;
+	}
+
+	if (UNeuroStrikeTombSubsystem* Tombs = GetWorld()->GetSubsystem<UNeuroStrikeTombSubsystem>()) {
+		Tombs->AddTomb(this->TombMesh, GetActorTransform());
 	}
 }
 
 void ANeuroStrikeCharacter::DecreaseStamina(float StaminaCost) {
-	this->BaseStamina -= StaminaCost;
+	this->SetStamina(this->GetStamina() - StaminaCost);
 }
 
-void ANeuroStrikeCharacter::DecreaseHealth(float DamageAmount) {
-	if (HasAuthority()) {
-		Health -= DamageAmount;
-		if (Health <= 0.0f) {
-			Health = 0.0f;
-		}
+bool ANeuroStrikeCharacter::DecreaseHealth(float DamageAmount) {
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Character DecreaseHealth", STAT_NeuroStrike_DecreaseHealth);
 
-		if (Health == 0.0f) {
-			Multicast_OnDespawnEffects();
-			Destroy();
-		}
+	if (!this->HasAuthority() || this->bIsDead || this->Health <= 0.0f) {
+		return false;
+	}
+
+	this->Health = FMath::Max(this->Health - DamageAmount, 0.0f);
+	this->RefreshReplicatedMovementState();
+
+	return this->Health == 0.0f;
+}
+
+void ANeuroStrikeCharacter::Die() {
+	if (!this->HasAuthority() || this->bIsDead) {
+		return;
+	}
+
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Character Die", STAT_NeuroStrike_Die);
+
+	this->bIsDead = true;
+	this->SpawnTomb();
+
+	ANeuroStrikeGameMode* GameMode = GetWorld()->GetAuthGameMode<ANeuroStrikeGameMode>();
+	if (GameMode == nullptr) {
+		this->Destroy();
+		return;
+	}
+
+	this->ApplyDeathState();
+	this->ForceNetUpdate();
+	GameMode->QueueRespawn(this);
+}
+
+void ANeuroStrikeCharacter::Respawn(const FTransform& SpawnTransform) {
+	if (!this->HasAuthority() || !this->bIsDead) {
+		return;
 	}
+
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Character Respawn", STAT_NeuroStrike_Respawn);
+
+	const float OldHealth = this->Health;
+	const FRotator SpawnRotation(0.0f, SpawnTransform.Rotator().Yaw, 0.0f);
+	this->TeleportTo(SpawnTransform.GetLocation(), SpawnRotation, false, true);
+	if (this->Controller != nullptr) {
+		this->Controller->ClientSetRotation(SpawnRotation);
+	}
+
+	// The rewind history must not interpolate between the place of death and the spawn point.
+	this->TransformHistory.Reset();
+
+	this->bIsDead = false;
+	this->Health = this->MaxHealth;
+	this->SetStamina(this->MaxStamina);
+	this->ApplyDeathState();
+	this->NotifyHealthChanged(OldHealth);
+	this->ForceNetUpdate();
+}
+
+void ANeuroStrikeCharacter::OnRep_IsDead() {
+	this->ApplyDeathState();
 }
 
-void ANeuroStrikeCharacter::DecreaseHealthHandler(float HealthCost) {
-	if (this->GetLocalRole() == ROLE_Authority) {
-		this->DecreaseHealth(HealthCost);
+void ANeuroStrikeCharacter::ApplyDeathState() {
+	const bool bAlive = !this->bIsDead;
+
+	this->SetActorHiddenInGame(!bAlive);
+	this->SetActorEnableCollision(bAlive);
+
+	// Hiding an actor leaves the actors attached to it alone, such as the picked up rifle.
+	TArray<AActor*> AttachedActors;
+	this->GetAttachedActors(AttachedActors);
+	for (AActor* AttachedActor : AttachedActors) {
+		AttachedActor->SetActorHiddenInGame(!bAlive);
+		AttachedActor->SetActorEnableCollision(bAlive);
+	}
+
+	// The rifle's component is attached on its own when it is not the root of its actor.
+	if (this->WeaponComponent != nullptr) {
+		this->WeaponComponent->SetHiddenInGame(!bAlive, true);
+	}
+
+	UNeuroStrikeMovementComponent* Movement = this->GetNeuroStrikeMovement();
+	if (bAlive) {
+		Movement->SetDefaultMovementMode();
+	} else {
+		Movement->StopMovementImmediately();
+		Movement->DisableMovement();
+		this->StopSprinting();
+	}
+
+	if (!bAlive && this->WeaponComponent != nullptr) {
+		this->WeaponComponent->CancelFiring();
+	}
+}
+
+void ANeuroStrikeCharacter::NotifyHealthChanged(float OldHealth) {
+	if (this->Health == OldHealth) {
+		return;
+	}
+
+	this->UpdateDebugOverlay();
+	this->OnHealthChanged(OldHealth, this->Health);
+}
+
+bool ANeuroStrikeCharacter::ConsumeServerRpcBudget(FName RpcName) const {
+	ANeuroStrikePlayerController* PlayerController = Cast<ANeuroStrikePlayerController>(this->Controller);
+	return PlayerController == nullptr || PlayerController->ConsumeServerRpcBudget(RpcName);
+}
+
+void ANeuroStrikeCharacter::NotifyServerRpcSent() const {
+	if (ANeuroStrikePlayerController* PlayerController = Cast<ANeuroStrikePlayerController>(this->Controller)) {
+		PlayerController->NotifyServerRpcSent();
+	}
+}
+
+UNeuroStrikeMovementComponent* ANeuroStrikeCharacter::GetNeuroStrikeMovement() const {
+	return CastChecked<UNeuroStrikeMovementComponent>(this->GetCharacterMovement());
+}
+
+void ANeuroStrikeCharacter::OnSprintStateChanged(bool bIsSprinting) {
+	this->RefreshReplicatedMovementState();
+}
+
+void ANeuroStrikeCharacter::RefreshReplicatedMovementState() {
+	if (!this->HasAuthority()) {
+		return;
+	}
+
+	const uint8 QuantizedHealth = FNeuroStrikeMovementState::Quantize(this->Health, this->MaxHealth);
+
+	this->OwnerMovementState.Health = QuantizedHealth;
+
+	this->SimulatedMovementState.Health = QuantizedHealth;
+	this->SimulatedMovementState.bIsSprinting = this->GetNeuroStrikeMovement()->IsSprinting();
+}
+
+void ANeuroStrikeCharacter::OnRep_OwnerMovementState() {
+	const float OldHealth = this->Health;
+	this->Health = FNeuroStrikeMovementState::Dequantize(this->OwnerMovementState.Health, this->MaxHealth);
+
+	if (this->Health != OldHealth) {
+		this->NotifyHealthChanged(OldHealth);
 	} else {
-		this->ServerDecreaseHealth(HealthCost);
+		this->UpdateDebugOverlay();
 	}
 }
 
-void ANeuroStrikeCharacter::ServerDecreaseHealth_Implementation(float HealthCost) {
-	this->Health -= HealthCost;
-	if (this->Health <= 0.0f) {
-		this->Health = 0.0f;
+void ANeuroStrikeCharacter::OnRep_SimulatedMovementState() {
+	const float OldHealth = this->Health;
+	this->Health = FNeuroStrikeMovementState::Dequantize(this->SimulatedMovementState.Health, this->MaxHealth);
+	this->GetNeuroStrikeMovement()->SetWantsToSprint(this->SimulatedMovementState.bIsSprinting);
+
+	if (this->Health < OldHealth) {
+		if (UNeuroStrikeLatencySubsystem* Latency = GetWorld()->GetSubsystem<UNeuroStrikeLatencySubsystem>()) {
+			Latency->NotifyRemoteHealthDropped(this);
+		}
 	}
-	this->ServerDespawn();
+
+	this->NotifyHealthChanged(OldHealth);
+}
+
+void ANeuroStrikeCharacter::UpdateDebugOverlay() const {
+#if NEUROSTRIKE_WITH_DEBUG_OVERLAY
+	if (GEngine == nullptr) {
+		return;
+	}
+
+	if (NeuroStrikeDebug::ShowVitals <= 0) {
+		GEngine->RemoveOnScreenDebugMessage(this->PlayerId);
+		return;
+	}
+
+	// Kept on screen until the next change replaces it under the same key.
+	GEngine->AddOnScreenDebugMessage(this->PlayerId, TNumericLimits<float>::Max(), FColor::Red,
+	                                 FString::Printf(TEXT("%s Health: %.1f Stamina: %.1f"), *GetName(),
+	                                                 this->Health, this->GetStamina()));
+#endif
 }
 
 void ANeuroStrikeCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ANeuroStrikeCharacter, Health);
+	DOREPLIFETIME_CONDITION(ANeuroStrikeCharacter, OwnerMovementState, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(ANeuroStrikeCharacter, SimulatedMovementState, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(ANeuroStrikeCharacter, ReplicatedAim, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(ANeuroStrikeCharacter, FireState, COND_SkipOwner);
+	DOREPLIFETIME(ANeuroStrikeCharacter, bIsDead);
+}
+
+void ANeuroStrikeCharacter::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) {
+	Super::PreReplication(ChangedPropertyTracker);
+
+	this->ReplicatedAim.Set(this->GetBaseAimRotation());
+}
+
+FRotator ANeuroStrikeCharacter::GetReplicatedAimRotation() const {
+	if (this->Controller != nullptr || this->HasAuthority()) {
+		return this->GetBaseAimRotation();
+	}
+
+	return this->ReplicatedAim.Get();
+}
+
+void ANeuroStrikeCharacter::NotifyControllerChanged() {
+	Super::NotifyControllerChanged();
+
+	if (this->WeaponComponent != nullptr) {
+		this->WeaponComponent->RefreshController();
+	}
+
+	this->UpdateFirstPersonMeshEvaluation();
+}
+
+void ANeuroStrikeCharacter::UpdateFirstPersonMeshEvaluation() {
+	// The arms are only visible to the player viewing through this character; everyone else skips their bones.
+	if (this->Mesh1P == nullptr) {
+		return;
+	}
+
+	// Unlike IsPlayerControlled, this does not depend on the player state, which may replicate after the
+	// controller on the owning client.
+	const bool bIsViewedLocally = this->Controller != nullptr && this->Controller->IsLocalPlayerController();
+	this->Mesh1P->bNoSkeletonUpdate = !bIsViewedLocally;
+	this->Mesh1P->SetComponentTickEnabled(bIsViewedLocally);
 }
@@ -5,18 +5,134 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
+#include "NeuroStrikeTransformHistory.h"
 #include "NeuroStrikeCharacter.generated.h"
 
-class AStaticMeshActor;
 class UInputComponent;
 class USkeletalMeshComponent;
 class UCameraComponent;
 class UInputAction;
 class UInputMappingContext;
+class UNeuroStrikeMovementComponent;
 struct FInputActionValue;
+struct FNeuroStrikeFrameInput;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
+/**
+ * Compact replicated snapshot of a character's vitals and sprint state.
+ *
+ * Health is quantized to a byte over its maximum value and sprinting is a single bit, so a snapshot costs 9 bits.
+ * The same struct is replicated twice with different conditions: the owning client receives health, everyone
+ * else receives health and the sprint bit. The owner predicts its own stamina and reconciles it through the
+ * movement component's move responses, which compare it against the server's for the same move.
+ */
+USTRUCT()
+struct FNeuroStrikeMovementState {
+	GENERATED_BODY()
+
+	/** Health quantized over MaxHealth. */
+	UPROPERTY()
+	uint8 Health = 0;
+
+	/** Whether the character is moving at sprint speed. */
+	UPROPERTY()
+	bool bIsSprinting = false;
+
+	/**
+	 * Quantizes a value in the range [0, Max] to a byte.
+	 *
+	 * @param Value The value to quantize.
+	 * @param Max The upper bound of the range.
+	 * @return The quantized value.
+	 */
+	static uint8 Quantize(float Value, float Max);
+
+	/**
+	 * Expands a byte produced by Quantize back to the range [0, Max].
+	 *
+	 * @param Quantized The quantized value.
+	 * @param Max The upper bound of the range.
+	 * @return The reconstructed value.
+	 */
+	static float Dequantize(uint8 Quantized, float Max);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FNeuroStrikeMovementState& Other) const {
+		return this->Health == Other.Health && this->bIsSprinting == Other.bIsSprinting;
+	}
+};
+
+template <>
+struct TStructOpsTypeTraits<FNeuroStrikeMovementState> : public TStructOpsTypeTraitsBase2<FNeuroStrikeMovementState> {
+	enum {
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+/**
+ * Aim direction of a character with each axis quantized to 16 bits.
+ *
+ * Replicated to every connection except the owner, so that the shots and effects of other characters can be
+ * computed from where they aim without their controller or camera.
+ */
+USTRUCT()
+struct FNeuroStrikeQuantizedAim {
+	GENERATED_BODY()
+
+	/** Pitch compressed with FRotator::CompressAxisToShort. */
+	UPROPERTY()
+	uint16 Pitch = 0;
+
+	/** Yaw compressed with FRotator::CompressAxisToShort. */
+	UPROPERTY()
+	uint16 Yaw = 0;
+
+	/**
+	 * Quantizes an aim rotation. Roll is dropped.
+	 *
+	 * @param Rotation The aim rotation.
+	 */
+	void Set(const FRotator& Rotation);
+
+	/** @return The aim rotation reconstructed from the quantized axes. */
+	FRotator Get() const;
+
+	bool operator==(const FNeuroStrikeQuantizedAim& Other) const {
+		return this->Pitch == Other.Pitch && this->Yaw == Other.Yaw;
+	}
+};
+
+/**
+ * Firing sequence a character's weapon runs on the server, as replicated to every connection except the owner.
+ *
+ * Sequences are fully described by their first shot and their length, so other clients replay their cosmetic
+ * shots at the weapon's cadence on their own. Replication therefore costs one update per trigger press and one
+ * per release, however many bullets are fired.
+ */
+USTRUCT()
+struct FNeuroStrikeFireState {
+	GENERATED_BODY()
+
+	/** Incremented by every sequence the server starts, so back-to-back presses are told apart. */
+	UPROPERTY()
+	uint8 Sequence = 0;
+
+	/** Sequence number of the first shot. */
+	UPROPERTY()
+	uint16 FirstShotId = 0;
+
+	/** Shots of the sequence, or INDEX_NONE while an automatic sequence waits for its release. */
+	UPROPERTY()
+	int32 ShotCount = INDEX_NONE;
+
+	/** Server world time the first shot was due. */
+	UPROPERTY()
+	float StartTime = 0.0f;
+};
+
 /**
  * Represents a character in the NeuroStrike game with first-person capabilities, weapon usage, and customizable input actions.
  *
@@ -29,11 +145,17 @@ UCLASS(config=Game)
 class ANeuroStrikeCharacter : public ACharacter {
 	GENERATED_BODY()
 
+	/** Bots drive the character through the same input handlers as players. */
+	friend class ANeuroStrikeBotController;
+
+	/** Bot clients inject input into the character's input actions. */
+	friend class ANeuroStrikeBotPlayerController;
+
 	/**
 	 * Represents the first-person skeletal mesh for the character.
 	 *
 	 * Serves as the visual representation of the character's arms and weapon in first-person perspective,
-	 * ensuring precision and alignment with the player's viewpoint during gameplay.
+	 * ensuring precision and alignment with the player's viewpoint during gameplay. Null on dedicated servers.
 	 */
 	UPROPERTY(VisibleDefaultsOnly, Category=Mesh)
 	USkeletalMeshComponent* Mesh1P;
@@ -112,17 +234,31 @@ protected:
 	 */
 	virtual void BeginPlay() override;
 
+	/**
+	 * Handles cleanup when the character is removed from the world.
+	 *
+	 * Stops the server from recording the character's transform history for lag compensation.
+	 *
+	 * @param EndPlayReason The reason the character is leaving play.
+	 */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	/**
 	 * Constructs an instance of ANeuroStrikeCharacter with default settings.
 	 *
 	 * This constructor initializes the character's components and properties, including the collision capsule,
 	 * first-person camera, and skeletal mesh for the first-person perspective. It also sets the initial state
-	 * of the character, such as not having a rifle.
+	 * of the character, such as not having a rifle. The default character movement component is replaced with
+	 * UNeuroStrikeMovementComponent, which predicts sprinting.
 	 *
+	 * @param ObjectInitializer The initializer used to override the movement component class.
 	 * @return An initialized ANeuroStrikeCharacter instance with default configurations and components attached.
 	 */
-	ANeuroStrikeCharacter();
+	ANeuroStrikeCharacter(const FObjectInitializer& ObjectInitializer);
+
+	/** Keeps the tomb mesh out of server cooks, which only replicate its path. */
+	virtual void Serialize(FArchive& Ar) override;
 
 	/**
 	 * Represents the weapon functionality for the character.
@@ -166,24 +302,46 @@ public:
 	bool GetHasRifle();
 
 	/**
-	 * Initiates the server-side logic for firing a weapon.
+	 * Tells the server that the owning client pulled the trigger.
+	 *
+	 * One RPC per trigger press: the server replays the weapon's fire mode and cadence from the start time,
+	 * so automatic fire does not cost an RPC per bullet.
 	 *
-	 * This method is called to ensure that the firing action is handled with server authority.
-	 * It is designed for replication and ensures consistency across the network
-	 * by propagating the firing request from the client to the server.
+	 * @param StartTime The server world time of the world state the client saw when pulling the trigger,
+	 *                  used to rewind other characters before each shot is resolved.
+	 * @param FirstShotId Sequence number of the first shot of this trigger press.
 	 */
 	UFUNCTION(Server, Reliable)
-	void ServerFire();
+	void ServerStartFiring(float StartTime, uint16 FirstShotId);
 
 	/**
-	 * Triggers the firing visual effects for the character.
+	 * Tells the server that the owning client released the trigger of an automatic weapon.
 	 *
-	 * This method is executed across all clients and is intended to display the visual effects
-	 * associated with firing a weapon. It does not handle the actual shooting logic or server authority,
-	 * focusing solely on client-side effects such as muzzle flashes or particle animations.
+	 * Releases of a running automatic sequence are always processed; any other call is rate limited like
+	 * ServerStartFiring.
+	 *
+	 * @param StopTime The server world time of the release, in the same time base as StartTime.
+	 * @param LastShotId Sequence number of the last shot the client fired before releasing.
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerStopFiring(float StopTime, uint16 LastShotId);
+
+	/**
+	 * Publishes a firing sequence the weapon just started, so other clients replay its cosmetic shots.
+	 * Authority only.
+	 *
+	 * @param StartTime Server world time the first shot is due.
+	 * @param FirstShotId Sequence number of the first shot.
+	 * @param ShotCount Shots of the sequence, or INDEX_NONE for an automatic sequence that waits for its release.
+	 */
+	void NotifyFireStarted(float StartTime, uint16 FirstShotId, int32 ShotCount);
+
+	/**
+	 * Publishes the final length of the current firing sequence, once released or cancelled. Authority only.
+	 *
+	 * @param ShotCount Shots the sequence fires in total.
 	 */
-	UFUNCTION(NetMulticast, Unreliable)
-	void FireFX();
+	void NotifyFireStopped(int32 ShotCount);
 
 	/**
 	 * Executes the firing mechanism of the character.
@@ -191,9 +349,73 @@ public:
 	 * This method triggers the shooting action, which includes handling projectiles through
 	 * the weapon component and activating associated visual or auditory effects.
 	 * It ensures the weapon component is valid before executing the shooting logic.
+	 *
+	 * @param ShotTime The server world time the shot was fired at, used for lag compensation.
+	 * @param ShotId Sequence number of the shot, used by the owning client to reconcile its prediction.
 	 */
 	UFUNCTION()
-	void Shoot();
+	void Shoot(float ShotTime, uint16 ShotId);
+
+	/**
+	 * Runs the per-frame server work of the character that only touches its own state.
+	 *
+	 * Called by the lag compensation subsystem for every character, once the characters have moved for the
+	 * frame. Records the capsule into the transform history and, when due, picks the network update tier. Must
+	 * not have side effects outside the character, so the phase can move to worker threads; anything else is
+	 * returned and applied by CommitServerPhase.
+	 *
+	 * @param Time The server world time of the frame.
+	 * @return The network update frequency to switch to, or zero to keep the current one.
+	 */
+	float RunServerPhase(float Time);
+
+	/**
+	 * Applies the results of RunServerPhase. Game thread only.
+	 *
+	 * @param Time The server world time of the frame.
+	 * @param NetUpdateFrequency The frequency returned by RunServerPhase.
+	 */
+	void CommitServerPhase(float Time, float NetUpdateFrequency);
+
+	/**
+	 * Reconstructs the capsule transform the character had at the given time.
+	 *
+	 * @param Time The server world time to reconstruct.
+	 * @param OutLocation Receives the capsule location at that time.
+	 * @param OutRotation Receives the capsule rotation at that time.
+	 * @return false if no history has been recorded for this character.
+	 */
+	bool GetHistoricalTransform(float Time, FVector& OutLocation, FQuat& OutRotation) const;
+
+	/**
+	 * Estimates the server world time of the world state this client currently displays.
+	 *
+	 * Remote characters reach the client half a round trip after the server simulated them, so the
+	 * estimate is the synchronized server time minus half of the measured ping.
+	 *
+	 * @return The server world time to send with a shot.
+	 */
+	float GetClientShotTime() const;
+
+	/**
+	 * Retrieves where the character aims without going through its controller.
+	 *
+	 * @return The replicated aim on clients that do not own the character, otherwise the base aim rotation.
+	 */
+	FRotator GetReplicatedAimRotation() const;
+
+	/** Refreshes the replicated aim from the control rotation right before the character is replicated. */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	/** Lets the equipped weapon cache the new controller. */
+	virtual void NotifyControllerChanged() override;
+
+	/**
+	 * Applies the look and move input a player controller gathered over a frame, through Look and Move.
+	 *
+	 * @param Input The frame's input. Actions without samples are left untouched.
+	 */
+	void ApplyFrameInput(const FNeuroStrikeFrameInput& Input);
 
 protected:
 	/**
@@ -219,15 +441,47 @@ protected:
 	void Look(const FInputActionValue& Value);
 
 	/**
-	 * Handles the firing action triggered by player input.
+	 * Handles the movement action, gathering its value into the NeuroStrike player controller's frame input,
+	 * or moving right away under any other controller.
+	 *
+	 * @param Value The input value representing the 2D vector for movement direction.
+	 */
+	void GatherMoveInput(const FInputActionValue& Value);
+
+	/**
+	 * Handles the look action, gathering its delta into the NeuroStrike player controller's frame input,
+	 * or turning right away under any other controller.
+	 *
+	 * @param Value The input value representing the 2D vector for camera rotation.
+	 */
+	void GatherLookInput(const FInputActionValue& Value);
+
+	/**
+	 * Handles the fire input being pressed.
 	 *
-	 * This method determines if the character is the server authority and either performs a local shoot action
-	 * or calls a server-side firing function for network replication.
+	 * Starts the weapon's firing sequence locally and, without authority, sends a single ServerStartFiring
+	 * with the trigger time and the first shot's sequence number.
 	 *
 	 * @param InputActionValue Represents the input value associated with the firing action.
 	 */
 	void Fire(const FInputActionValue& InputActionValue);
 
+	/**
+	 * Handles the fire input being released.
+	 *
+	 * Only automatic weapons react to the release; the server is told which shot was the last one.
+	 *
+	 * @param InputActionValue Represents the input value associated with the firing action.
+	 */
+	void StopFire(const FInputActionValue& InputActionValue);
+
+	/**
+	 * Retrieves the server world time shots of this character are stamped with.
+	 *
+	 * @return The current world time with authority, GetClientShotTime otherwise.
+	 */
+	float GetShotTime() const;
+
 	/**
 	 * Defines the movement speed of the character while walking.
 	 *
@@ -252,9 +506,10 @@ protected:
 	/**
 	 * Handles the sprinting action for the NeuroStrike character.
 	 *
-	 * This method is triggered by an input action and adjusts the character's movement speed
-	 * to the sprinting speed if the player has sufficient stamina and is currently moving.
-	 * If the player doesn't meet these conditions, the sprint action is stopped.
+	 * This method is triggered once when the sprint input is pressed and requests sprinting from
+	 * the movement component, which applies the sprinting speed and spends stamina while the player
+	 * has stamina and is walking. The request travels to the server with the saved moves, so
+	 * sprinting is predicted.
 	 *
 	 * @param InputActionValue The input value associated with the sprint action, typically
 	 * used for detecting whether the sprint command is active.
@@ -272,11 +527,11 @@ protected:
 	bool IsPlayerMoving();
 
 	/**
-	 * Stops the sprinting action and resets the character's movement speed to the walking speed.
+	 * Stops the sprinting action and returns the character to the walking speed.
 	 *
-	 * This method reverts the character's maximum walk speed to the predefined walking speed,
-	 * effectively ending any active sprinting behavior. It ensures the character transitions
-	 * back to a normal walking state.
+	 * This method withdraws the sprint request from the movement component, effectively ending
+	 * any active sprinting behavior. It ensures the character transitions back to a normal
+	 * walking state.
 	 */
 	void StopSprinting();
 
@@ -289,11 +544,146 @@ protected:
 
 	int32 PlayerId;
 
+	/**
+	 * Number of capsule transforms kept for lag compensation.
+	 *
+	 * The history is allocated once in BeginPlay and must cover the server's maximum rewind window
+	 * at its tick rate; 64 samples are a little over a second at 60 Hz.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Lag Compensation", meta=(ClampMin="1"))
+	int32 TransformHistoryLength = 64;
+
+	/** Server-side ring buffer of recent capsule transforms used to rewind this character for hit resolution. */
+	FNeuroStrikeTransformHistory TransformHistory;
+
+	/** Health replicated to the owning client only. */
+	UPROPERTY(ReplicatedUsing=OnRep_OwnerMovementState)
+	FNeuroStrikeMovementState OwnerMovementState;
+
+	/** Health and sprint state replicated to every connection except the owner. */
+	UPROPERTY(ReplicatedUsing=OnRep_SimulatedMovementState)
+	FNeuroStrikeMovementState SimulatedMovementState;
+
+	/** Quantized aim replicated to every connection except the owner. */
+	UPROPERTY(Replicated)
+	FNeuroStrikeQuantizedAim ReplicatedAim;
+
+	/** Firing sequence of the weapon replicated to every connection except the owner, which predicts its own. */
+	UPROPERTY(ReplicatedUsing=OnRep_FireState)
+	FNeuroStrikeFireState FireState;
+
+	/**
+	 * Seconds past the end of a finished sequence during which other clients still replay it. Older sequences,
+	 * such as the last one of a character that just became relevant, are not replayed.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon, meta=(ClampMin="0"))
+	float MaxRemoteFireDelay = 0.5f;
+
+	/**
+	 * Replays the replicated firing sequence on other clients.
+	 *
+	 * @param OldFireState The sequence replicated before this update.
+	 */
+	UFUNCTION()
+	void OnRep_FireState(const FNeuroStrikeFireState& OldFireState);
+
+	/** Applies the replicated owner state on the owning client. */
+	UFUNCTION()
+	void OnRep_OwnerMovementState();
+
+	/** Applies the replicated simulated state on other clients. */
+	UFUNCTION()
+	void OnRep_SimulatedMovementState();
+
+	/**
+	 * Rebuilds both replicated movement states from the authoritative values.
+	 * Only does anything with authority; unchanged states are not sent again.
+	 */
+	void RefreshReplicatedMovementState();
+
+	/**
+	 * Network update frequency used while the character stands still and does not shoot.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Replication", meta=(ClampMin="1"))
+	float IdleNetUpdateFrequency = 10.0f;
+
+	/**
+	 * Network update frequency used while the character moves.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Replication", meta=(ClampMin="1"))
+	float MovingNetUpdateFrequency = 30.0f;
+
+	/**
+	 * Network update frequency used while the character fires and for FiringNetUpdateDuration afterwards.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Replication", meta=(ClampMin="1"))
+	float FiringNetUpdateFrequency = 60.0f;
+
+	/**
+	 * Seconds after the last shot during which the character stays in the firing tier.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Replication", meta=(ClampMin="0"))
+	float FiringNetUpdateDuration = 1.0f;
+
+	/**
+	 * Seconds between two evaluations of the network update tier on the server.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Replication", meta=(ClampMin="0.05"))
+	float NetUpdateTierInterval = 0.25f;
+
+	/** Server world time of the last shot, used to select the firing tier. */
+	float LastShotTime = -1.0f;
+
+	/** Server world time at which the server phase re-evaluates the network update tier. */
+	float NextNetUpdateTierTime = 0.0f;
+
+	/**
+	 * Chooses the idle, moving or firing network update frequency from the character's current activity.
+	 *
+	 * Idle characters replicate rarely and, together with the replication graph, cost almost nothing in the
+	 * server's actor list; a character that starts shooting is promoted immediately from Shoot. Only reads
+	 * the character, so it is safe to call from RunServerPhase.
+	 *
+	 * @param Time The server world time to evaluate the tier at.
+	 * @return The network update frequency of the tier.
+	 */
+	float ComputeNetUpdateFrequency(float Time) const;
+
+	/**
+	 * Switches to a new network update frequency, forcing an update right away when it is higher.
+	 *
+	 * @param Frequency The new network update frequency.
+	 */
+	void ApplyNetUpdateFrequency(float Frequency);
+
+	/** Set once the character has gone through Die, cleared when it respawns. */
+	UPROPERTY(ReplicatedUsing=OnRep_IsDead)
+	bool bIsDead = false;
+
+	/** Applies the replicated death state on clients. */
+	UFUNCTION()
+	void OnRep_IsDead();
+
+	/**
+	 * Hides the character and disables its collision, movement and firing while it is dead, and restores them
+	 * once it is alive again. Components, input bindings and the actor channel are kept either way.
+	 */
+	void ApplyDeathState();
+
+	/** Timer that fires once stamina has regenerated to MaxStamina. */
+	FTimerHandle StaminaRegenTimerHandle;
+
+	/**
+	 * Handles stamina reaching MaxStamina, the only regeneration threshold that needs a wake-up.
+	 */
+	void OnStaminaRegenerated();
+
 public:
 	/**
 	 * Retrieves the first-person skeletal mesh component associated with this character.
 	 *
-	 * @return A pointer to the USkeletalMeshComponent representing the first-person mesh component.
+	 * @return A pointer to the USkeletalMeshComponent representing the first-person mesh component, or null on
+	 *         dedicated servers.
 	 */
 	USkeletalMeshComponent* GetMesh1P() const {
 		return Mesh1P;
@@ -308,32 +698,92 @@ public:
 		return FirstPersonCameraComponent;
 	}
 
-	virtual void Tick(float DeltaSeconds) override;
+	/**
+	 * Kills the character through the regular damage pipeline, crediting nobody.
+	 */
 	void Despawn();
 
+	/** Kills the character on request of its owning client. Rate limited per connection. */
 	UFUNCTION(Server, Reliable)
 	void ServerDespawn();
 
 	void DecreaseStamina(float StaminaCost);
 
-	void DecreaseHealth(float HealthCost);
+	/**
+	 * Removes health from the character. Authority only.
+	 *
+	 * Only called by UNeuroStrikeDamageSubsystem while it applies the frame's damage events; every other
+	 * damage source queues an event there instead. Does not kill the character, the subsystem does that
+	 * once all hits of the frame are applied.
+	 *
+	 * @param HealthCost The health to remove.
+	 * @return true if this call took the character's health to zero.
+	 */
+	bool DecreaseHealth(float HealthCost);
 
-	void DecreaseHealthHandler(float HealthCost);
+	/**
+	 * Runs the death of the character: places its tomb and deactivates it until the game mode respawns it.
+	 * Characters outside an ANeuroStrikeGameMode are destroyed instead.
+	 *
+	 * Guarded so that it runs at most once per life, whatever the number of lethal hits.
+	 * Authority only.
+	 */
+	void Die();
 
-	UFUNCTION(Server, Reliable)
-	void ServerDecreaseHealth(float HealthCost);
+	/**
+	 * Brings a dead character back at the given transform with full health and stamina. Authority only.
+	 *
+	 * @param SpawnTransform Where the character reappears. Only location and yaw are used.
+	 */
+	void Respawn(const FTransform& SpawnTransform);
+
+	/**
+	 * Checks whether the character has died.
+	 *
+	 * @return true once Die has run.
+	 */
+	bool IsDead() const {
+		return this->bIsDead;
+	}
+
+	/**
+	 * Runs the cosmetic reactions to a health change once, however many hits caused it.
+	 *
+	 * Called on the server once per frame after the damage subsystem applied every hit, and on clients when
+	 * the replicated health arrives.
+	 *
+	 * @param OldHealth The health before the change.
+	 */
+	void NotifyHealthChanged(float OldHealth);
+
+	/**
+	 * Blueprint hook for hit reactions, health bars and similar effects.
+	 *
+	 * @param OldHealth The health before the change.
+	 * @param NewHealth The current health.
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category="Player")
+	void OnHealthChanged(float OldHealth, float NewHealth);
 
 	/**
  * Represents the base stamina value for the player.
  *
- * This value determines the starting stamina of the player. It is initialized
- * to 100.0f by default and remains constant unless modified. Stamina depletion
- * and regeneration mechanisms depend on this base value to set boundaries for the
- * player's stamina management.
+ * This is the stamina the player had at StaminaChangeTime, the last time stamina was
+ * spent or set. Current stamina is derived from it on demand by GetStamina, adding the
+ * regeneration accumulated since then, so nothing has to be updated while it regenerates.
  */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
 	float BaseStamina;
 
+	/**
+	 * World time at which BaseStamina was last written.
+	 *
+	 * Together with BaseStamina and StaminaRegenRate this fully describes the stamina curve
+	 * until the next change.
+	 */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	float StaminaChangeTime = 0.0f;
+
 	/**
 	 * Maximum stamina value for the player.
 	 *
@@ -347,12 +797,33 @@ public:
 	/**
 	 * Rate at which stamina regenerates over time.
 	 *
-	 * This variable defines the amount of stamina replenished per second. It is set to 0.2 by
-	 * default, meaning the player's stamina will increase at a steady rate of 0.2 per second
+	 * This variable defines the amount of stamina replenished per second. It is set to 2.0 by
+	 * default, meaning the player's stamina will increase at a steady rate of 2.0 per second
 	 * during periods of regeneration. Adjusting this value can control the speed of stamina recovery.
 	 */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	float StaminaRegenRate = 0.2f;
+	float StaminaRegenRate = 2.0f;
+
+	/**
+	 * Computes the current stamina of the player.
+	 *
+	 * Stamina is evaluated lazily from the last change: BaseStamina plus StaminaRegenRate for every
+	 * second elapsed since StaminaChangeTime, capped at MaxStamina.
+	 *
+	 * @return The player's stamina at the current world time.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetStamina() const;
+
+	/**
+	 * Sets the current stamina of the player and restarts regeneration from that value.
+	 *
+	 * Schedules a single timer for the moment stamina becomes full again instead of updating
+	 * it over time.
+	 *
+	 * @param NewStamina The new stamina value, clamped to the range [0, MaxStamina].
+	 */
+	void SetStamina(float NewStamina);
 
 	/**
 	 * Determines if the player has enough stamina to perform an action.
@@ -371,14 +842,62 @@ public:
 	UPROPERTY(VisibleAnywhere)
 	float MaxHealth = 100.0f;
 
-	UPROPERTY(Replicated)
+	/**
+	 * Current health of the character.
+	 *
+	 * Owned by the server. Clients reconstruct it from the quantized replicated movement state.
+	 */
+	UPROPERTY(VisibleAnywhere)
 	float Health;
 
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_OnDespawnEffects();
+	/**
+	 * Retrieves the movement component of this character.
+	 *
+	 * @return The NeuroStrike movement component that predicts sprinting.
+	 */
+	UNeuroStrikeMovementComponent* GetNeuroStrikeMovement() const;
+
+	/**
+	 * Handles the movement component starting or stopping sprinting.
+	 *
+	 * @param bIsSprinting true if the character started sprinting, false if it stopped.
+	 */
+	void OnSprintStateChanged(bool bIsSprinting);
+
+	/**
+	 * Refreshes the on-screen health and stamina overlay of this character.
+	 *
+	 * Called whenever health or stamina changes instead of every frame. Does nothing unless the
+	 * NeuroStrike.Debug.ShowVitals console variable is set, and compiles to nothing in builds
+	 * without debug overlays.
+	 */
+	void UpdateDebugOverlay() const;
+
+	/**
+	 * Places the tomb of this character where it died. Authority only.
+	 *
+	 * Tombs are added once on the server to the instanced tomb field of their mesh and replicated from there,
+	 * rather than spawned as individual actors on every machine.
+	 */
+	void SpawnTomb();
+
+	/** Enables bone evaluation of the first-person mesh only when a local player views through this character. */
+	void UpdateFirstPersonMeshEvaluation();
+
+	/**
+	 * Consumes a call of a rate-limited server RPC from the connection owning this character.
+	 *
+	 * @param RpcName Name of the RPC.
+	 * @return true if the call should be processed. Characters without a player controller are not limited.
+	 */
+	bool ConsumeServerRpcBudget(FName RpcName) const;
+
+	/** Counts a server RPC sent by the owning client on its player controller, for load-test reports. */
+	void NotifyServerRpcSent() const;
 
+	/** Mesh of the tomb left where the character dies. Never loaded on the server, which only references it. */
 	UPROPERTY(EditAnywhere, Category="Player")
-	UStaticMesh* TombMesh;
+	TSoftObjectPtr<UStaticMesh> TombMesh;
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 };
@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeDamageSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "NeuroStrikeGameState.h"
+#include "NeuroStrikeMatchRecorderSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+
+void UNeuroStrikeDamageSubsystem::Deinitialize() {
+	this->PendingEvents.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNeuroStrikeDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UNeuroStrikeDamageSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNeuroStrikeDamageSubsystem, STATGROUP_NeuroStrike);
+}
+
+void UNeuroStrikeDamageSubsystem::QueueDamage(const FNeuroStrikeDamageEvent& Event) {
+	if (this->GetWorld()->GetNetMode() == NM_Client || Event.Amount <= 0.0f) {
+		return;
+	}
+
+	this->PendingEvents.Add(Event);
+}
+
+void UNeuroStrikeDamageSubsystem::QueueDamage(ANeuroStrikeCharacter* Instigator, ANeuroStrikeCharacter* Victim,
+                                              float Amount, const FVector& HitLocation) {
+	FNeuroStrikeDamageEvent Event;
+	Event.Instigator = Instigator;
+	Event.Victim = Victim;
+	Event.Amount = Amount;
+	Event.HitLocation = HitLocation;
+	this->QueueDamage(Event);
+}
+
+void UNeuroStrikeDamageSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	if (this->PendingEvents.Num() == 0) {
+		return;
+	}
+
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Damage Apply", STAT_NeuroStrike_ApplyDamage);
+	INC_DWORD_STAT_BY(STAT_NeuroStrike_DamageEvents, this->PendingEvents.Num());
+
+	// Deaths are resolved only after every hit of the frame has been applied, so a victim hit several times
+	// in the same frame dies once and the kill goes to the hit that took its health to zero.
+	TArray<FNeuroStrikeKillEvent, TInlineAllocator<8>> Kills;
+	TArray<ANeuroStrikeCharacter*, TInlineAllocator<8>> Victims;
+
+	// Health before the first hit of the frame of every damaged character, so each reacts once to its total.
+	TArray<TPair<ANeuroStrikeCharacter*, float>, TInlineAllocator<16>> Damaged;
+
+	UNeuroStrikeMatchRecorderSubsystem* Recorder = UNeuroStrikeMatchRecorderSubsystem::GetActive(this->GetWorld());
+
+	for (const FNeuroStrikeDamageEvent& Event : this->PendingEvents) {
+		ANeuroStrikeCharacter* Victim = Event.Victim.Get();
+		if (Victim == nullptr || Victim->IsDead()) {
+			continue;
+		}
+
+		if (!Damaged.ContainsByPredicate([Victim](const TPair<ANeuroStrikeCharacter*, float>& Entry) {
+			return Entry.Key == Victim;
+		})) {
+			Damaged.Emplace(Victim, Victim->Health);
+		}
+
+		if (Recorder != nullptr) {
+			Recorder->RecordDamage(Event.Instigator.Get(), Victim, Event.Amount);
+		}
+
+		if (!Victim->DecreaseHealth(Event.Amount)) {
+			continue;
+		}
+
+		const ANeuroStrikeCharacter* Killer = Event.Instigator.Get();
+
+		FNeuroStrikeKillEvent& Kill = Kills.AddDefaulted_GetRef();
+		Kill.Killer = Killer != nullptr ? Killer->GetPlayerState() : nullptr;
+		Kill.Victim = Victim->GetPlayerState();
+		Kill.Location = Victim->GetActorLocation();
+		Victims.Add(Victim);
+	}
+
+	this->PendingEvents.Reset();
+
+	for (const TPair<ANeuroStrikeCharacter*, float>& Entry : Damaged) {
+		Entry.Key->NotifyHealthChanged(Entry.Value);
+	}
+
+	for (ANeuroStrikeCharacter* Victim : Victims) {
+		Victim->Die();
+	}
+
+	if (Kills.Num() > 0) {
+		if (ANeuroStrikeGameState* GameState = this->GetWorld()->GetGameState<ANeuroStrikeGameState>()) {
+			INC_DWORD_STAT(STAT_NeuroStrike_RPC_MulticastOnKills);
+			GameState->Multicast_OnKills(TArray<FNeuroStrikeKillEvent>(Kills));
+		}
+	}
+}
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikeDamageSubsystem.generated.h"
+
+class ANeuroStrikeCharacter;
+
+/**
+ * A single hit waiting to be applied by the damage subsystem.
+ */
+USTRUCT()
+struct FNeuroStrikeDamageEvent {
+	GENERATED_BODY()
+
+	/** The character credited for the hit. May be unset for environmental damage. */
+	UPROPERTY()
+	TWeakObjectPtr<ANeuroStrikeCharacter> Instigator;
+
+	/** The character receiving the damage. */
+	UPROPERTY()
+	TWeakObjectPtr<ANeuroStrikeCharacter> Victim;
+
+	/** Health removed from the victim. */
+	UPROPERTY()
+	float Amount = 0.0f;
+
+	/** World location of the hit. */
+	UPROPERTY()
+	FVector_NetQuantize HitLocation = FVector::ZeroVector;
+};
+
+/**
+ * Server-side subsystem through which every hit reaches a character.
+ *
+ * Projectiles, hitscan traces and any other damage source only enqueue compact damage events. Once per frame the
+ * queue is applied in a single pass: health is reduced, characters that reached zero health are collected, each
+ * of them goes through the death pipeline exactly once, and all kills of the frame are announced to clients
+ * with one batched multicast on the game state instead of one RPC per death.
+ */
+UCLASS()
+class NEUROSTRIKE_API UNeuroStrikeDamageSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Applies every damage event queued since the previous frame and resolves the resulting deaths.
+	 *
+	 * @param DeltaTime Time elapsed since the previous frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Queues a hit to be applied with the next batch. Ignored without authority.
+	 *
+	 * @param Event The hit to apply.
+	 */
+	void QueueDamage(const FNeuroStrikeDamageEvent& Event);
+
+	/**
+	 * Convenience overload building the damage event from its parts.
+	 *
+	 * @param Instigator The character credited for the hit.
+	 * @param Victim The character receiving the damage.
+	 * @param Amount Health removed from the victim.
+	 * @param HitLocation World location of the hit.
+	 */
+	void QueueDamage(ANeuroStrikeCharacter* Instigator, ANeuroStrikeCharacter* Victim, float Amount,
+	                 const FVector& HitLocation);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Damage events queued since the last batch. */
+	TArray<FNeuroStrikeDamageEvent> PendingEvents;
+};
@@ -0,0 +1,7 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeFirstPersonMeshComponent.h"
+
+bool UNeuroStrikeFirstPersonMeshComponent::NeedsLoadForServer() const {
+	return false;
+}
@@ -0,0 +1,21 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "NeuroStrikeFirstPersonMeshComponent.generated.h"
+
+/**
+ * Skeletal mesh component of the first-person arms, which only the owning client ever sees.
+ *
+ * Never loaded by servers: server cooks strip it, with the mesh and animations it references, from every package,
+ * and characters never create it in a dedicated server process.
+ */
+UCLASS()
+class NEUROSTRIKE_API UNeuroStrikeFirstPersonMeshComponent : public USkeletalMeshComponent {
+	GENERATED_BODY()
+
+public:
+	virtual bool NeedsLoadForServer() const override;
+};
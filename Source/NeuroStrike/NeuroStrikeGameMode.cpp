@@ -1,11 +1,126 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "NeuroStrikeGameMode.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeBotPlayerController.h"
 #include "NeuroStrikeCharacter.h"
-#include "UObject/ConstructorHelpers.h"
+#include "NeuroStrikeGameState.h"
+#include "NeuroStrikePlayerController.h"
+#include "NeuroStrikePreloadSubsystem.h"
+#include "TimerManager.h"
+#include "HAL/PlatformTime.h"
+#include "GameFramework/GameSession.h"
+#include "Kismet/GameplayStatics.h"
 
 ANeuroStrikeGameMode::ANeuroStrikeGameMode() : Super() {
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(
-		TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter"));
-	this->DefaultPawnClass = PlayerPawnClassFinder.Class;
+	this->PlayerPawnClass = TSoftClassPtr<APawn>(
+		FSoftObjectPath(TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter.BP_FirstPersonCharacter_C")));
+	this->DefaultPawnClass = ANeuroStrikeCharacter::StaticClass();
+	this->GameStateClass = ANeuroStrikeGameState::StaticClass();
+	this->PlayerControllerClass = ANeuroStrikePlayerController::StaticClass();
+	this->BotPlayerControllerClass = ANeuroStrikeBotPlayerController::StaticClass();
+}
+
+void ANeuroStrikeGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) {
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	if (this->GameSession != nullptr) {
+		this->GameSession->MaxSplitscreensPerConnection = FMath::Max(this->GameSession->MaxSplitscreensPerConnection,
+		                                                             this->MaxSplitscreensPerConnection);
+	}
+
+	if (UNeuroStrikePreloadSubsystem* Preload = GetWorld()->GetSubsystem<UNeuroStrikePreloadSubsystem>()) {
+		Preload->RequestAsyncLoad({this->PlayerPawnClass.ToSoftObjectPath()}, false,
+		                          FStreamableDelegate::CreateUObject(
+			                          this, &ANeuroStrikeGameMode::OnPlayerPawnClassLoaded));
+	}
+}
+
+void ANeuroStrikeGameMode::StartPlay() {
+	Super::StartPlay();
+
+	if (GetNetMode() != NM_DedicatedServer) {
+		return;
+	}
+
+	// GStartTime is taken as the process launches, so this covers engine init, module startup and the map load.
+	UE_LOG(LogNeuroStrike, Log, TEXT("Dedicated server ready %.2f s after launch"),
+	       FPlatformTime::Seconds() - GStartTime);
+	NeuroStrikeStats::LogMemoryReport(TEXT("startup"));
+
+	if (this->MemoryReportInterval > 0.0f) {
+		const FTimerDelegate Report = FTimerDelegate::CreateStatic(&NeuroStrikeStats::LogMemoryReport, TEXT("periodic"));
+		GetWorldTimerManager().SetTimer(this->MemoryReportTimerHandle, Report, this->MemoryReportInterval, true);
+	}
+}
+
+UClass* ANeuroStrikeGameMode::GetDefaultPawnClassForController_Implementation(AController* InController) {
+	if (this->PlayerPawnClass.IsNull()) {
+		return Super::GetDefaultPawnClassForController_Implementation(InController);
+	}
+
+	if (this->PlayerPawnClass.Get() == nullptr) {
+		UE_LOG(LogNeuroStrike, Warning, TEXT("Player pawn class %s requested before streaming finished"),
+		       *this->PlayerPawnClass.ToString());
+		this->PlayerPawnClass.LoadSynchronous();
+		this->OnPlayerPawnClassLoaded();
+	}
+
+	return Super::GetDefaultPawnClassForController_Implementation(InController);
+}
+
+APlayerController* ANeuroStrikeGameMode::SpawnPlayerController(ENetRole InRemoteRole, const FString& Options) {
+	if (this->BotPlayerControllerClass != nullptr && UGameplayStatics::HasOption(Options, TEXT("Bot"))) {
+		return this->SpawnPlayerControllerCommon(InRemoteRole, FVector::ZeroVector, FRotator::ZeroRotator,
+		                                         this->BotPlayerControllerClass);
+	}
+
+	return Super::SpawnPlayerController(InRemoteRole, Options);
+}
+
+void ANeuroStrikeGameMode::OnPlayerPawnClassLoaded() {
+	if (UClass* LoadedClass = this->PlayerPawnClass.Get()) {
+		this->DefaultPawnClass = LoadedClass;
+	}
+}
+
+void ANeuroStrikeGameMode::QueueRespawn(ANeuroStrikeCharacter* Character) {
+	if (Character == nullptr) {
+		return;
+	}
+
+	FPendingRespawn& Pending = this->PendingRespawns.AddDefaulted_GetRef();
+	Pending.Character = Character;
+	Pending.RespawnTime = GetWorld()->GetTimeSeconds() + this->RespawnDelay;
+
+	if (!GetWorldTimerManager().IsTimerActive(this->RespawnTimerHandle)) {
+		GetWorldTimerManager().SetTimer(this->RespawnTimerHandle, this, &ANeuroStrikeGameMode::RespawnDueCharacters,
+		                                FMath::Max(this->RespawnDelay, KINDA_SMALL_NUMBER), false);
+	}
+}
+
+void ANeuroStrikeGameMode::RespawnDueCharacters() {
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	int32 DueCount = 0;
+	while (DueCount < this->PendingRespawns.Num() && this->PendingRespawns[DueCount].RespawnTime <= Now) {
+		++DueCount;
+	}
+
+	for (int32 Index = 0; Index < DueCount; ++Index) {
+		ANeuroStrikeCharacter* Character = this->PendingRespawns[Index].Character.Get();
+		if (Character == nullptr || !Character->IsDead()) {
+			continue;
+		}
+
+		const AActor* Start = this->ChoosePlayerStart(Character->GetController());
+		Character->Respawn(Start != nullptr ? Start->GetActorTransform() : Character->GetActorTransform());
+	}
+	this->PendingRespawns.RemoveAt(0, DueCount, false);
+
+	if (this->PendingRespawns.Num() > 0) {
+		GetWorldTimerManager().SetTimer(this->RespawnTimerHandle, this, &ANeuroStrikeGameMode::RespawnDueCharacters,
+		                                FMath::Max(this->PendingRespawns[0].RespawnTime - Now, KINDA_SMALL_NUMBER),
+		                                false);
+	}
 }
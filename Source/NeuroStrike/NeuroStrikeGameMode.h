@@ -6,6 +6,8 @@
 #include "GameFramework/GameModeBase.h"
 #include "NeuroStrikeGameMode.generated.h"
 
+class ANeuroStrikeCharacter;
+
 /**
  * @class ANeuroStrikeGameMode
  * @brief Custom game mode class for the NeuroStrike game.
@@ -18,7 +20,11 @@
  * and other gameplay logic relevant to the game mode.
  *
  * The constructor initializes the game mode, including setting up
- * the default pawn class.
+ * the default pawn class. The pawn class is a soft reference that is
+ * streamed in while the map loads instead of being loaded with the game mode.
+ *
+ * Dead characters are not destroyed: they stay deactivated, with their components, input bindings and actor
+ * channel, until RespawnDelay has elapsed and they are moved to a player start with full health.
  */
 UCLASS(minimalapi)
 class ANeuroStrikeGameMode : public AGameModeBase {
@@ -30,11 +36,87 @@ public:
 	 *
 	 * This constructor initializes the NeuroStrike game mode by setting up
 	 * the default pawn class for player characters. The default pawn is configured
-	 * using a Blueprint-defined character found at a specified asset path.
+	 * using a soft reference to a Blueprint-defined character at a specified asset path.
 	 *
 	 * The constructor ensures that the game mode is properly initialized for gameplay.
 	 *
 	 * @return An instance of ANeuroStrikeGameMode with configured game mode properties.
 	 */
 	ANeuroStrikeGameMode();
+
+	/**
+	 * Starts streaming the player pawn class as soon as the map starts loading.
+	 */
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	/**
+	 * Logs how long a dedicated server took to start and how much memory it uses once the match is about to start,
+	 * then every MemoryReportInterval seconds.
+	 */
+	virtual void StartPlay() override;
+
+	/**
+	 * Returns the streamed player pawn class, loading it on the spot only if a player joins before streaming
+	 * has finished.
+	 */
+	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
+
+	/**
+	 * Spawns a bot player controller for connections joining with the Bot URL option, and a regular player
+	 * controller otherwise, so load-test clients run the bot logic on their side of the connection.
+	 */
+	virtual APlayerController* SpawnPlayerController(ENetRole InRemoteRole, const FString& Options) override;
+
+	/**
+	 * Schedules a dead character to be brought back once RespawnDelay has elapsed.
+	 *
+	 * @param Character The character that just died. Must already be deactivated.
+	 */
+	void QueueRespawn(ANeuroStrikeCharacter* Character);
+
+	/** Seconds a dead character stays deactivated before it respawns */
+	UPROPERTY(EditDefaultsOnly, Category=Respawn, meta=(ClampMin="0"))
+	float RespawnDelay = 3.0f;
+
+protected:
+	/** Player controller class spawned for bot clients joining with the Bot URL option. */
+	UPROPERTY(EditDefaultsOnly, Category=Classes)
+	TSubclassOf<APlayerController> BotPlayerControllerClass;
+
+	/**
+	 * Players a single client connection may add on top of its first one. Bot clients run many bots as split-screen
+	 * players of one connection, which the engine caps to a handful by default.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=Bots, meta=(ClampMin="0"))
+	int32 MaxSplitscreensPerConnection = 64;
+
+	/** Seconds between two memory reports of a dedicated server. Zero only reports once, at startup. */
+	UPROPERTY(EditDefaultsOnly, Category=Profiling, meta=(ClampMin="0"))
+	float MemoryReportInterval = 60.0f;
+
+	/** Pawn class spawned for players, streamed in asynchronously by InitGame. */
+	UPROPERTY(EditDefaultsOnly, Category=Classes)
+	TSoftClassPtr<APawn> PlayerPawnClass;
+
+private:
+	/** Adopts the streamed pawn class as the default pawn class. */
+	void OnPlayerPawnClassLoaded();
+
+	/** Respawns every queued character whose delay has elapsed and re-arms the timer for the next one. */
+	void RespawnDueCharacters();
+
+	/** A dead character waiting for its respawn time. */
+	struct FPendingRespawn {
+		TWeakObjectPtr<ANeuroStrikeCharacter> Character;
+		float RespawnTime = 0.0f;
+	};
+
+	/** Characters waiting to respawn, ordered by respawn time since every death uses the same delay. */
+	TArray<FPendingRespawn> PendingRespawns;
+
+	/** Timer firing at the respawn time of the first pending character. */
+	FTimerHandle RespawnTimerHandle;
+
+	/** Timer of the periodic memory reports of a dedicated server. */
+	FTimerHandle MemoryReportTimerHandle;
 };
@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeGameState.h"
+#include "NeuroStrike.h"
+#include "Engine/Engine.h"
+#include "GameFramework/PlayerState.h"
+
+void ANeuroStrikeGameState::Multicast_OnKills_Implementation(const TArray<FNeuroStrikeKillEvent>& Kills) {
+	for (const FNeuroStrikeKillEvent& Kill : Kills) {
+#if NEUROSTRIKE_WITH_DEBUG_OVERLAY
+		if (GEngine != nullptr) {
+			GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red,
+			                                 FString::Printf(TEXT("%s is dead"),
+			                                                 Kill.Victim != nullptr
+				                                                 ? *Kill.Victim->GetPlayerName()
+				                                                 : TEXT("Unknown player")));
+		}
+#endif
+
+		this->OnKill.Broadcast(Kill);
+	}
+}
@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/GameStateBase.h"
+#include "NeuroStrikeGameState.generated.h"
+
+class APlayerState;
+
+/**
+ * A kill announced to every client.
+ */
+USTRUCT(BlueprintType)
+struct FNeuroStrikeKillEvent {
+	GENERATED_BODY()
+
+	/** Player credited for the kill, if any. */
+	UPROPERTY(BlueprintReadOnly, Category=Kill)
+	TObjectPtr<APlayerState> Killer;
+
+	/** Player that died. */
+	UPROPERTY(BlueprintReadOnly, Category=Kill)
+	TObjectPtr<APlayerState> Victim;
+
+	/** World location the victim died at. */
+	UPROPERTY(BlueprintReadOnly, Category=Kill)
+	FVector_NetQuantize Location = FVector::ZeroVector;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FNeuroStrikeOnKill, const FNeuroStrikeKillEvent&, Kill);
+
+/**
+ * Game state of NeuroStrike matches.
+ *
+ * Carries match-wide events to clients. Kills are sent in batches, one multicast per server frame however
+ * many players died in it, and re-broadcast locally through OnKill for kill feeds and scoring.
+ */
+UCLASS()
+class NEUROSTRIKE_API ANeuroStrikeGameState : public AGameStateBase {
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Announces every kill of a server frame.
+	 *
+	 * @param Kills The kills resolved during the frame, in resolution order.
+	 */
+	UFUNCTION(NetMulticast, Reliable)
+	void Multicast_OnKills(const TArray<FNeuroStrikeKillEvent>& Kills);
+
+	/** Broadcast on every machine for each announced kill. */
+	UPROPERTY(BlueprintAssignable, Category=Kill)
+	FNeuroStrikeOnKill OnKill;
+};
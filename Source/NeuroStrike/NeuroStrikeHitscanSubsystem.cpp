@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeHitscanSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "NeuroStrikeDamageSubsystem.h"
+#include "NeuroStrikeLagCompensationSubsystem.h"
+#include "NeuroStrikeLatencySubsystem.h"
+#include "NeuroStrikeWeaponDefinition.h"
+#include "Engine/World.h"
+
+void UNeuroStrikeHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	this->TraceDelegate.BindUObject(this, &UNeuroStrikeHitscanSubsystem::OnTraceCompleted);
+}
+
+void UNeuroStrikeHitscanSubsystem::Deinitialize() {
+	this->TraceDelegate.Unbind();
+	this->PendingShots.Empty();
+	this->InFlightShots.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNeuroStrikeHitscanSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UNeuroStrikeHitscanSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNeuroStrikeHitscanSubsystem, STATGROUP_NeuroStrike);
+}
+
+void UNeuroStrikeHitscanSubsystem::QueueShot(const FNeuroStrikeHitscanRequest& Request) {
+	this->PendingShots.Add(Request);
+}
+
+void UNeuroStrikeHitscanSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	if (this->PendingShots.Num() == 0) {
+		return;
+	}
+
+	UWorld* World = this->GetWorld();
+	const UNeuroStrikeLagCompensationSubsystem* LagCompensation = World->GetSubsystem<
+		UNeuroStrikeLagCompensationSubsystem>();
+	this->InFlightShots.Reserve(this->InFlightShots.Num() + this->PendingShots.Num());
+
+	for (const FNeuroStrikeHitscanRequest& Request : this->PendingShots) {
+		if (Request.bLagCompensated) {
+			FNeuroStrikeHitscanRequest& Rewound = this->RewoundShots.Add_GetRef(Request);
+			if (LagCompensation != nullptr) {
+				Rewound.ShotTime = LagCompensation->ClampRewindTime(Request.ShotTime);
+			}
+			continue;
+		}
+
+		const uint32 ShotId = this->NextShotId++;
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(NeuroStrikeHitscan), false, Request.Instigator.Get());
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Request.Start, Request.End, Request.TraceChannel,
+		                               QueryParams, FCollisionResponseParams::DefaultResponseParam,
+		                               &this->TraceDelegate, ShotId);
+
+		this->InFlightShots.Add(ShotId, Request);
+	}
+
+	this->PendingShots.Reset();
+
+	if (this->RewoundShots.Num() > 0) {
+		this->ResolveRewoundShots(this->RewoundShots);
+		this->RewoundShots.Reset();
+	}
+}
+
+void UNeuroStrikeHitscanSubsystem::OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum) {
+	FNeuroStrikeHitscanRequest Request;
+	if (!this->InFlightShots.RemoveAndCopyValue(TraceDatum.UserData, Request)) {
+		return;
+	}
+
+	this->ApplyShotResult(Request, TraceDatum.OutHits);
+}
+
+void UNeuroStrikeHitscanSubsystem::ResolveRewoundShots(TArray<FNeuroStrikeHitscanRequest>& Requests) {
+	UWorld* World = this->GetWorld();
+	const UNeuroStrikeLagCompensationSubsystem* LagCompensation = World->GetSubsystem<
+		UNeuroStrikeLagCompensationSubsystem>();
+
+	Requests.Sort([](const FNeuroStrikeHitscanRequest& A, const FNeuroStrikeHitscanRequest& B) {
+		return A.ShotTime < B.ShotTime;
+	});
+
+	TArray<TPair<int32, FHitResult>, TInlineAllocator<16>> Hits;
+	for (int32 First = 0; First < Requests.Num();) {
+		int32 End = First + 1;
+		while (End < Requests.Num() && Requests[End].ShotTime - Requests[First].ShotTime <= this->RewindGroupWindow) {
+			++End;
+		}
+
+		TOptional<FNeuroStrikeScopedRewind> Rewind;
+		if (LagCompensation != nullptr) {
+			Rewind.Emplace(*LagCompensation, 0.5f * (Requests[First].ShotTime + Requests[End - 1].ShotTime));
+		}
+
+		for (int32 Index = First; Index < End; ++Index) {
+			const FNeuroStrikeHitscanRequest& Request = Requests[Index];
+			FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(NeuroStrikeRewoundHitscan), false,
+			                                  Request.Instigator.Get());
+			FHitResult Hit;
+			if (World->LineTraceSingleByChannel(Hit, Request.Start, Request.End, Request.TraceChannel, QueryParams)) {
+				Hits.Emplace(Index, Hit);
+			}
+		}
+
+		First = End;
+	}
+
+	// Damage is only applied once every character is back where it currently is.
+	for (const TPair<int32, FHitResult>& Hit : Hits) {
+		this->ApplyShotResult(Requests[Hit.Key], MakeArrayView(&Hit.Value, 1));
+	}
+}
+
+void UNeuroStrikeHitscanSubsystem::ApplyShotResult(const FNeuroStrikeHitscanRequest& Request,
+                                                   TConstArrayView<FHitResult> Hits) {
+	for (const FHitResult& Hit : Hits) {
+		if (!Hit.bBlockingHit) {
+			continue;
+		}
+
+		if (UNeuroStrikeLatencySubsystem* Latency = this->GetWorld()->GetSubsystem<UNeuroStrikeLatencySubsystem>()) {
+			Latency->RecordSpan(Request.Instigator.Get(), ENeuroStrikeLatencySpan::ShotToHit,
+			                    this->GetWorld()->GetTimeSeconds() - Request.QueueTime);
+		}
+
+		if (ANeuroStrikeCharacter* HitCharacter = Cast<ANeuroStrikeCharacter>(Hit.GetActor())) {
+			if (UNeuroStrikeDamageSubsystem* Damage = this->GetWorld()->GetSubsystem<UNeuroStrikeDamageSubsystem>()) {
+				const float Falloff = Request.WeaponStats.IsValid() ? Request.WeaponStats->GetFalloff(Hit.Distance) : 1.0f;
+				Damage->QueueDamage(Request.Instigator.Get(), HitCharacter, Request.Damage * Falloff, Hit.ImpactPoint);
+			}
+		}
+		break;
+	}
+}
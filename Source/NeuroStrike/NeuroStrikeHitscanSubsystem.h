@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "NeuroStrikeHitscanSubsystem.generated.h"
+
+class ANeuroStrikeCharacter;
+struct FNeuroStrikeWeaponStats;
+
+/**
+ * A single hitscan shot waiting to be traced.
+ */
+USTRUCT()
+struct FNeuroStrikeHitscanRequest {
+	GENERATED_BODY()
+
+	/** The character that fired the shot. Ignored by the trace and credited for the damage. */
+	UPROPERTY()
+	TWeakObjectPtr<ANeuroStrikeCharacter> Instigator;
+
+	/** World location the trace starts from. */
+	UPROPERTY()
+	FVector Start = FVector::ZeroVector;
+
+	/** World location the trace ends at. */
+	UPROPERTY()
+	FVector End = FVector::ZeroVector;
+
+	/** Damage applied to the first character hit by the trace, before falloff. */
+	UPROPERTY()
+	float Damage = 0.0f;
+
+	/** Stats of the weapon that fired the shot, whose falloff is applied by hit distance. No falloff when null. */
+	TSharedPtr<const FNeuroStrikeWeaponStats> WeaponStats;
+
+	/** Collision channel the trace runs against. */
+	UPROPERTY()
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	/** Server world time the shooter saw when firing. */
+	UPROPERTY()
+	float ShotTime = 0.0f;
+
+	/** Whether the shot is resolved against characters rewound to ShotTime. */
+	UPROPERTY()
+	bool bLagCompensated = false;
+
+	/** Server world time the shot was queued at, to measure how long it took to resolve. */
+	UPROPERTY()
+	float QueueTime = 0.0f;
+};
+
+/**
+ * Server-side subsystem that resolves hitscan shots in batches.
+ *
+ * Shots are queued during the frame and dispatched together as asynchronous line traces at the end of it.
+ * The physics scene resolves the whole batch on worker threads, and the results are applied on the game
+ * thread as damage events for UNeuroStrikeDamageSubsystem once they come back.
+ *
+ * Lag compensated shots must see the rewound world, which only exists for the duration of a rewind scope,
+ * so they are traced synchronously instead of joining the asynchronous batch. The frame's rewound shots are
+ * grouped by rewind time, and each group is traced inside a single rewind scope, so characters are only moved
+ * back and forth once per group rather than once per shot.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikeHitscanSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Dispatches every shot queued since the previous frame as a single batch of asynchronous traces.
+	 *
+	 * @param DeltaTime Time elapsed since the previous frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Queues a hitscan shot to be traced with the next batch.
+	 *
+	 * @param Request The shot to resolve.
+	 */
+	void QueueShot(const FNeuroStrikeHitscanRequest& Request);
+
+	/**
+	 * Widest spread of rewind times, in seconds, traced within a single rewind. Every shot of a group is
+	 * resolved at the middle of the group's times, so this bounds the rewind error to half of it.
+	 */
+	UPROPERTY(config)
+	float RewindGroupWindow = 0.008f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * Traces lag compensated shots against characters rewound to their shot times, one rewind per group of
+	 * close shot times, and applies the results once every character is restored.
+	 *
+	 * @param Requests The shots to resolve, with their shot times already clamped. Sorted by shot time in place.
+	 */
+	void ResolveRewoundShots(TArray<FNeuroStrikeHitscanRequest>& Requests);
+
+	/**
+	 * Applies damage for the first blocking hit of a resolved shot.
+	 *
+	 * @param Request The resolved shot.
+	 * @param Hits The hits found by the trace, nearest first.
+	 */
+	void ApplyShotResult(const FNeuroStrikeHitscanRequest& Request, TConstArrayView<FHitResult> Hits);
+
+	/**
+	 * Applies the result of a finished trace.
+	 *
+	 * @param TraceHandle Handle of the finished trace.
+	 * @param TraceDatum Trace input and output, carrying the shot id in its user data.
+	 */
+	void OnTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Shots queued since the last dispatch. */
+	TArray<FNeuroStrikeHitscanRequest> PendingShots;
+
+	/** Lag compensated shots of the current dispatch, kept to reuse its allocation. */
+	TArray<FNeuroStrikeHitscanRequest> RewoundShots;
+
+	/** Dispatched shots waiting for their trace result, keyed by the id passed as trace user data. */
+	TMap<uint32, FNeuroStrikeHitscanRequest> InFlightShots;
+
+	/** Id handed to the next dispatched shot. */
+	uint32 NextShotId = 0;
+
+	/** Delegate bound to OnTraceCompleted, shared by every dispatched trace. */
+	FTraceDelegate TraceDelegate;
+};
@@ -0,0 +1,123 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeLagCompensationSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "PhysicsEngine/BodyInstance.h"
+
+void FNeuroStrikeCharacterPhaseTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType,
+                                                         ENamedThreads::Type CurrentThread,
+                                                         const FGraphEventRef& MyCompletionGraphEvent) {
+	if (this->Target != nullptr && TickType != LEVELTICK_ViewportsOnly) {
+		this->Target->RunCharacterPhase();
+	}
+}
+
+FString FNeuroStrikeCharacterPhaseTickFunction::DiagnosticMessage() {
+	return TEXT("UNeuroStrikeLagCompensationSubsystem[CharacterPhase]");
+}
+
+FName FNeuroStrikeCharacterPhaseTickFunction::DiagnosticContext(bool bDetailed) {
+	return FName(TEXT("NeuroStrikeCharacterPhase"));
+}
+
+void UNeuroStrikeLagCompensationSubsystem::OnWorldBeginPlay(UWorld& InWorld) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_Client) {
+		return;
+	}
+
+	this->CharacterPhaseTickFunction.Target = this;
+	this->CharacterPhaseTickFunction.TickGroup = TG_PrePhysics;
+	this->CharacterPhaseTickFunction.bCanEverTick = true;
+	this->CharacterPhaseTickFunction.bStartWithTickEnabled = true;
+	this->CharacterPhaseTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UNeuroStrikeLagCompensationSubsystem::Deinitialize() {
+	if (this->CharacterPhaseTickFunction.IsTickFunctionRegistered()) {
+		this->CharacterPhaseTickFunction.UnRegisterTickFunction();
+	}
+	this->CharacterPhaseTickFunction.Target = nullptr;
+
+	this->Characters.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNeuroStrikeLagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UNeuroStrikeLagCompensationSubsystem::RunCharacterPhase() {
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Character Phase", STAT_NeuroStrike_CharacterPhase);
+
+	const float Now = this->GetWorld()->GetTimeSeconds();
+	for (const TWeakObjectPtr<ANeuroStrikeCharacter>& Character : this->Characters) {
+		if (ANeuroStrikeCharacter* TrackedCharacter = Character.Get()) {
+			TrackedCharacter->CommitServerPhase(Now, TrackedCharacter->RunServerPhase(Now));
+		}
+	}
+}
+
+void UNeuroStrikeLagCompensationSubsystem::RegisterCharacter(ANeuroStrikeCharacter* Character) {
+	this->Characters.AddUnique(Character);
+
+	// Characters controlled on the server move during their own pre-physics tick; record them afterwards.
+	if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement()) {
+		this->CharacterPhaseTickFunction.AddPrerequisite(Movement, Movement->PrimaryComponentTick);
+	}
+}
+
+void UNeuroStrikeLagCompensationSubsystem::UnregisterCharacter(ANeuroStrikeCharacter* Character) {
+	this->Characters.RemoveSwap(Character);
+
+	if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement()) {
+		this->CharacterPhaseTickFunction.RemovePrerequisite(Movement, Movement->PrimaryComponentTick);
+	}
+}
+
+float UNeuroStrikeLagCompensationSubsystem::ClampRewindTime(float ShotTime) const {
+	const float Now = this->GetWorld()->GetTimeSeconds();
+	return FMath::Clamp(ShotTime, Now - this->MaxRewindTime, Now);
+}
+
+FNeuroStrikeScopedRewind::FNeuroStrikeScopedRewind(const UNeuroStrikeLagCompensationSubsystem& LagCompensation,
+                                                   float ShotTime) {
+	const float RewindTime = LagCompensation.ClampRewindTime(ShotTime);
+
+	for (const TWeakObjectPtr<ANeuroStrikeCharacter>& Character : LagCompensation.GetCharacters()) {
+		const ANeuroStrikeCharacter* TrackedCharacter = Character.Get();
+		if (TrackedCharacter == nullptr) {
+			continue;
+		}
+
+		FVector Location;
+		FQuat Rotation;
+		if (!TrackedCharacter->GetHistoricalTransform(RewindTime, Location, Rotation)) {
+			continue;
+		}
+
+		UCapsuleComponent* Capsule = TrackedCharacter->GetCapsuleComponent();
+		FBodyInstance* Body = Capsule->GetBodyInstance();
+		if (Body == nullptr || !Body->IsValidBodyInstance()) {
+			continue;
+		}
+
+		const FTransform& CurrentTransform = Capsule->GetComponentTransform();
+		this->RewoundBodies.Add({Body, CurrentTransform});
+		Body->SetBodyTransform(FTransform(Rotation, Location, CurrentTransform.GetScale3D()),
+		                       ETeleportType::TeleportPhysics);
+	}
+}
+
+FNeuroStrikeScopedRewind::~FNeuroStrikeScopedRewind() {
+	for (const FRewoundBody& Rewound : this->RewoundBodies) {
+		Rewound.Body->SetBodyTransform(Rewound.RestoreTransform, ETeleportType::TeleportPhysics);
+	}
+}
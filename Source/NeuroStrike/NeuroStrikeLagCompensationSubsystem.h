@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikeLagCompensationSubsystem.generated.h"
+
+class ANeuroStrikeCharacter;
+class UNeuroStrikeLagCompensationSubsystem;
+struct FBodyInstance;
+
+/**
+ * Tick function running the per-character server phase of UNeuroStrikeLagCompensationSubsystem.
+ */
+USTRUCT()
+struct FNeuroStrikeCharacterPhaseTickFunction : public FTickFunction {
+	GENERATED_BODY()
+
+	/** The subsystem whose characters are processed. */
+	UNeuroStrikeLagCompensationSubsystem* Target = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+	                         const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	virtual FString DiagnosticMessage() override;
+
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template <>
+struct TStructOpsTypeTraits<FNeuroStrikeCharacterPhaseTickFunction>
+	: public TStructOpsTypeTraitsBase2<FNeuroStrikeCharacterPhaseTickFunction> {
+	enum {
+		WithCopy = false
+	};
+};
+
+/**
+ * Server-side subsystem that keeps a transform history of every character and rewinds them for hit resolution.
+ *
+ * Characters register themselves on the server when they begin play. Every server frame, once the characters
+ * have moved, a pre-physics tick function runs the per-character work on the game thread: each character
+ * records its capsule into its own ring buffer, so a shot can later be judged against the positions the
+ * shooting client actually saw, and picks its network update tier. The phase is serial: a ring-buffer write and
+ * a tier check per character are too little work to pay for worker tasks at any realistic player count. The work
+ * still only touches the character it runs for, with its side effects committed separately, so it can be fanned
+ * out once there is per-character work heavy enough to.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikeLagCompensationSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** Registers the character phase tick function with the world. */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Deinitialize() override;
+
+	/**
+	 * Runs the per-character server phase for every character and commits its results.
+	 */
+	void RunCharacterPhase();
+
+	/**
+	 * Starts recording the transform history of a character. Its movement becomes a prerequisite of the
+	 * character phase, so the history always holds where the character ended up for the frame.
+	 *
+	 * @param Character The server-side character to track.
+	 */
+	void RegisterCharacter(ANeuroStrikeCharacter* Character);
+
+	/**
+	 * Stops recording the transform history of a character.
+	 *
+	 * @param Character The character to stop tracking.
+	 */
+	void UnregisterCharacter(ANeuroStrikeCharacter* Character);
+
+	/**
+	 * Clamps a client-provided shot time to the window the server is willing to rewind.
+	 *
+	 * @param ShotTime The server world time the client claims to have fired at.
+	 * @return The time to rewind to, never older than MaxRewindTime and never in the future.
+	 */
+	float ClampRewindTime(float ShotTime) const;
+
+	/**
+	 * Retrieves the characters whose history is being recorded.
+	 *
+	 * @return The registered characters. Entries may be stale while a character is being destroyed.
+	 */
+	const TArray<TWeakObjectPtr<ANeuroStrikeCharacter>>& GetCharacters() const {
+		return this->Characters;
+	}
+
+	/**
+	 * Longest time in seconds the server rewinds characters for a single shot.
+	 * Shots claiming to be older are resolved at this limit, which caps the advantage of very high pings.
+	 */
+	UPROPERTY(config)
+	float MaxRewindTime = 0.25f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Characters whose history is recorded every frame. */
+	TArray<TWeakObjectPtr<ANeuroStrikeCharacter>> Characters;
+
+	/** Tick function running the character phase in the pre-physics group. */
+	FNeuroStrikeCharacterPhaseTickFunction CharacterPhaseTickFunction;
+};
+
+/**
+ * Moves the collision of every tracked character back to where it was at a given time, for as long as the
+ * scope is alive.
+ *
+ * Only the physics bodies of the capsules are moved, so scene queries see the rewound positions without
+ * triggering any component movement, overlap or replication updates. Everything is restored on destruction.
+ */
+class NEUROSTRIKE_API FNeuroStrikeScopedRewind : public FNoncopyable {
+public:
+	/**
+	 * Rewinds every tracked character to the clamped shot time.
+	 *
+	 * @param LagCompensation The subsystem holding the tracked characters.
+	 * @param ShotTime The server world time to rewind to.
+	 */
+	FNeuroStrikeScopedRewind(const UNeuroStrikeLagCompensationSubsystem& LagCompensation, float ShotTime);
+
+	/** Restores every rewound character to its current transform. */
+	~FNeuroStrikeScopedRewind();
+
+private:
+	/** A capsule body moved by this scope and the transform it is restored to. */
+	struct FRewoundBody {
+		FBodyInstance* Body;
+		FTransform RestoreTransform;
+	};
+
+	/** Bodies moved by this scope. */
+	TArray<FRewoundBody, TInlineAllocator<32>> RewoundBodies;
+};
@@ -0,0 +1,256 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeLatencySubsystem.h"
+#include "NeuroStrike.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+namespace NeuroStrikeLatency {
+	/** Names of the spans, as reported. */
+	static const TCHAR* SpanNames[] = {
+		TEXT("FireToServer"),
+		TEXT("FireToShoot"),
+		TEXT("ShootToSpawn"),
+		TEXT("ShotToHit"),
+		TEXT("FireToHealth"),
+	};
+	static_assert(UE_ARRAY_COUNT(SpanNames) == static_cast<int32>(ENeuroStrikeLatencySpan::Count),
+	              "Every latency span needs a name");
+
+	static FAutoConsoleCommandWithWorld ReportCommand(
+		TEXT("NeuroStrike.Latency.Report"),
+		TEXT("Logs p50, p95 and p99 of every latency span of every player in the current world."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World) {
+			if (World != nullptr) {
+				if (const UNeuroStrikeLatencySubsystem* Latency = World->GetSubsystem<UNeuroStrikeLatencySubsystem>()) {
+					Latency->LogReport();
+				}
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorld DumpCsvCommand(
+		TEXT("NeuroStrike.Latency.DumpCsv"),
+		TEXT("Appends p50, p95 and p99 of every latency span of every player to the latency CSV file."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World) {
+			if (World != nullptr) {
+				if (UNeuroStrikeLatencySubsystem* Latency = World->GetSubsystem<UNeuroStrikeLatencySubsystem>()) {
+					Latency->DumpCsv();
+				}
+			}
+		}));
+}
+
+FNeuroStrikeLatencyRing::FNeuroStrikeLatencyRing(int32 Capacity) {
+	const uint32 SlotCount = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(Capacity, 1)));
+	this->Slots.SetNum(SlotCount);
+	this->Mask = SlotCount - 1;
+}
+
+void FNeuroStrikeLatencyRing::Push(const FNeuroStrikeLatencySample& Sample) {
+	this->Slots[this->WriteIndex++ & this->Mask] = Sample;
+}
+
+void FNeuroStrikeLatencyRing::Snapshot(TArray<FNeuroStrikeLatencySample>& OutSamples) const {
+	const uint32 Count = FMath::Min(this->WriteIndex, this->Mask + 1);
+
+	OutSamples.Reset(Count);
+	for (uint32 Offset = Count; Offset > 0; --Offset) {
+		OutSamples.Add(this->Slots[(this->WriteIndex - Offset) & this->Mask]);
+	}
+}
+
+UNeuroStrikeLatencySubsystem::UNeuroStrikeLatencySubsystem() = default;
+
+UNeuroStrikeLatencySubsystem::~UNeuroStrikeLatencySubsystem() = default;
+
+bool UNeuroStrikeLatencySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UNeuroStrikeLatencySubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNeuroStrikeLatencySubsystem, STATGROUP_NeuroStrike);
+}
+
+void UNeuroStrikeLatencySubsystem::OnWorldBeginPlay(UWorld& InWorld) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	const bool bDumpCsv = this->bDumpCsvByDefault || FParse::Param(FCommandLine::Get(), TEXT("NeuroStrikeLatencyCsv"));
+	this->bFireToHealthEnabled = this->bMeasureFireToHealth || bDumpCsv;
+
+	if (bDumpCsv) {
+		const TCHAR* Role = InWorld.GetNetMode() == NM_Client ? TEXT("Client") : TEXT("Server");
+		this->CsvPath = FPaths::ProfilingDir() / TEXT("Latency") / FString::Printf(
+			TEXT("%s_%s_%s.csv"), *InWorld.GetMapName(), Role, *FDateTime::Now().ToString());
+		this->TimeUntilCsvDump = this->CsvDumpInterval;
+		FFileHelper::SaveStringToFile(TEXT("Time,Player,Span,Count,Negative,P50,P95,P99\n"), *this->CsvPath);
+		UE_LOG(LogNeuroStrike, Log, TEXT("Dumping latency percentiles to %s"), *this->CsvPath);
+	}
+}
+
+void UNeuroStrikeLatencySubsystem::Deinitialize() {
+	if (!this->CsvPath.IsEmpty()) {
+		this->DumpCsv();
+	}
+
+	Super::Deinitialize();
+}
+
+void UNeuroStrikeLatencySubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	if (this->CsvPath.IsEmpty() || this->CsvDumpInterval <= 0.0f) {
+		return;
+	}
+
+	this->TimeUntilCsvDump -= DeltaTime;
+	if (this->TimeUntilCsvDump <= 0.0f) {
+		this->TimeUntilCsvDump = this->CsvDumpInterval;
+		this->DumpCsv();
+	}
+}
+
+void UNeuroStrikeLatencySubsystem::RecordSpan(const APawn* Shooter, ENeuroStrikeLatencySpan Span, double Seconds) {
+	const APlayerState* PlayerState = Shooter != nullptr ? Shooter->GetPlayerState() : nullptr;
+	if (PlayerState == nullptr) {
+		return;
+	}
+
+	FPlayerLatency& Player = this->Players.FindOrAdd(PlayerState->GetPlayerId());
+	if (!Player.Ring.IsValid()) {
+		Player.Name = PlayerState->GetPlayerName();
+		Player.Ring = MakeUnique<FNeuroStrikeLatencyRing>(this->SamplesPerPlayer);
+	}
+
+	// A clamped sample would drag the low percentiles down to zero, so clock estimation errors are kept apart.
+	if (Seconds < 0.0) {
+		++Player.NegativeSpans[static_cast<int32>(Span)];
+		return;
+	}
+
+	Player.Ring->Push({Span, static_cast<float>(Seconds * 1000.0)});
+}
+
+void UNeuroStrikeLatencySubsystem::NotifyLocalShot(const APawn* Shooter, float ShotTime, const AActor* Victim) {
+	if (const APlayerState* PlayerState = Shooter != nullptr ? Shooter->GetPlayerState() : nullptr) {
+		this->LocalShots.Add(PlayerState->GetPlayerId(), {ShotTime, Victim});
+	}
+}
+
+void UNeuroStrikeLatencySubsystem::NotifyRemoteHealthDropped(const AActor* Victim) {
+	const UWorld* World = this->GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	if (GameState == nullptr || Victim == nullptr || this->LocalShots.IsEmpty()) {
+		return;
+	}
+
+	const double Now = GameState->GetServerWorldTimeSeconds();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It) {
+		const APlayerController* PlayerController = It->Get();
+		const APawn* Shooter = PlayerController != nullptr ? PlayerController->GetPawn() : nullptr;
+		const APlayerState* PlayerState = Shooter != nullptr ? Shooter->GetPlayerState() : nullptr;
+		if (PlayerState == nullptr || !PlayerController->IsLocalController()) {
+			continue;
+		}
+
+		const int32 PlayerId = PlayerState->GetPlayerId();
+		const FLocalShot* Shot = this->LocalShots.Find(PlayerId);
+		if (Shot == nullptr) {
+			continue;
+		}
+
+		// Each shot is only credited with the first health drop of its victim, and forgotten once too old.
+		const double Elapsed = Now - Shot->ShotTime;
+		if (Elapsed > this->MaxHitAttributionTime) {
+			this->LocalShots.Remove(PlayerId);
+		} else if (Shot->Victim.Get() == Victim) {
+			this->LocalShots.Remove(PlayerId);
+			this->RecordSpan(Shooter, ENeuroStrikeLatencySpan::FireToHealth, Elapsed);
+		}
+	}
+}
+
+void UNeuroStrikeLatencySubsystem::ForEachSpanSummary(
+	const FPlayerLatency& Player,
+	TFunctionRef<void(ENeuroStrikeLatencySpan, int32, int32, float, float, float)> Visitor) {
+	TArray<FNeuroStrikeLatencySample> Samples;
+	Player.Ring->Snapshot(Samples);
+
+	TArray<float> SpanSamples[static_cast<int32>(ENeuroStrikeLatencySpan::Count)];
+	for (const FNeuroStrikeLatencySample& Sample : Samples) {
+		SpanSamples[static_cast<int32>(Sample.Span)].Add(Sample.Milliseconds);
+	}
+
+	for (int32 SpanIndex = 0; SpanIndex < UE_ARRAY_COUNT(SpanSamples); ++SpanIndex) {
+		TArray<float>& Values = SpanSamples[SpanIndex];
+		const int32 NumNegative = Player.NegativeSpans[SpanIndex];
+		if (Values.IsEmpty() && NumNegative == 0) {
+			continue;
+		}
+
+		Values.Sort();
+		const auto Percentile = [&Values](float Fraction) {
+			if (Values.IsEmpty()) {
+				return 0.0f;
+			}
+			const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Values.Num()) - 1, 0, Values.Num() - 1);
+			return Values[Index];
+		};
+
+		Visitor(static_cast<ENeuroStrikeLatencySpan>(SpanIndex), Values.Num(), NumNegative, Percentile(0.50f),
+		        Percentile(0.95f), Percentile(0.99f));
+	}
+}
+
+void UNeuroStrikeLatencySubsystem::LogReport() const {
+	using namespace NeuroStrikeLatency;
+
+	if (this->Players.IsEmpty()) {
+		UE_LOG(LogNeuroStrike, Log, TEXT("No latency samples recorded"));
+		return;
+	}
+
+	for (const TPair<int32, FPlayerLatency>& Pair : this->Players) {
+		const FString& Name = Pair.Value.Name;
+		ForEachSpanSummary(Pair.Value, [&Name](ENeuroStrikeLatencySpan Span, int32 Count, int32 NumNegative,
+		                                       float P50, float P95, float P99) {
+			UE_LOG(LogNeuroStrike, Log,
+			       TEXT("Latency %s %s: %d samples (%d negative), p50 %.1f ms, p95 %.1f ms, p99 %.1f ms"),
+			       *Name, SpanNames[static_cast<int32>(Span)], Count, NumNegative, P50, P95, P99);
+		});
+	}
+}
+
+void UNeuroStrikeLatencySubsystem::DumpCsv() {
+	using namespace NeuroStrikeLatency;
+
+	if (this->CsvPath.IsEmpty()) {
+		UE_LOG(LogNeuroStrike, Warning, TEXT("Latency CSV dump is disabled; start with -NeuroStrikeLatencyCsv"));
+		return;
+	}
+
+	const float Time = this->GetWorld()->GetTimeSeconds();
+	FString Csv;
+	for (const TPair<int32, FPlayerLatency>& Pair : this->Players) {
+		const FString& Name = Pair.Value.Name;
+		ForEachSpanSummary(Pair.Value, [&Csv, &Name, Time](ENeuroStrikeLatencySpan Span, int32 Count,
+		                                                  int32 NumNegative, float P50, float P95, float P99) {
+			Csv += FString::Printf(TEXT("%.3f,%s,%s,%d,%d,%.3f,%.3f,%.3f\n"), Time, *Name,
+			                       SpanNames[static_cast<int32>(Span)], Count, NumNegative, P50, P95, P99);
+		});
+	}
+
+	if (!Csv.IsEmpty()) {
+		FFileHelper::SaveStringToFile(Csv, *this->CsvPath, FFileHelper::EEncodingOptions::AutoDetect,
+		                              &IFileManager::Get(), FILEWRITE_Append);
+	}
+}
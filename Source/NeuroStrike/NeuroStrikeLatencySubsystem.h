@@ -0,0 +1,230 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikeLatencySubsystem.generated.h"
+
+class AActor;
+class APawn;
+
+/**
+ * Measured spans of the path from a trigger pull to its hit, named after their start and end markers.
+ */
+enum class ENeuroStrikeLatencySpan : uint8 {
+	/** Trigger pull in Fire on the owning client to ServerStartFiring being processed by the server. */
+	FireToServer,
+
+	/** Time a shot was due as the owning client saw it to the server running Shoot for it. */
+	FireToShoot,
+
+	/** Real time the server spends in HandleProjectile, spawning the shot's projectile or queuing its trace. */
+	ShootToSpawn,
+
+	/** Server time from a shot being handled to its projectile or trace hitting something. */
+	ShotToHit,
+
+	/** Latest local shot to the replicated health drop of the character it was aimed at arriving on the shooter. */
+	FireToHealth,
+
+	Count
+};
+
+/**
+ * A latency sample: the span it measures and its duration.
+ */
+struct FNeuroStrikeLatencySample {
+	ENeuroStrikeLatencySpan Span = ENeuroStrikeLatencySpan::Count;
+	float Milliseconds = 0.0f;
+};
+
+/**
+ * Fixed-size ring of a player's latest latency samples. Once full, the oldest samples are overwritten.
+ *
+ * Allocated once and never resized, so recording a sample costs a single store. Not thread-safe: like the
+ * subsystem owning it, it is only used on the game thread.
+ */
+class NEUROSTRIKE_API FNeuroStrikeLatencyRing {
+public:
+	/**
+	 * Allocates the ring.
+	 *
+	 * @param Capacity Samples kept, rounded up to a power of two.
+	 */
+	explicit FNeuroStrikeLatencyRing(int32 Capacity);
+
+	/**
+	 * Records a sample, overwriting the oldest one if the ring is full.
+	 *
+	 * @param Sample The sample to record.
+	 */
+	void Push(const FNeuroStrikeLatencySample& Sample);
+
+	/**
+	 * Copies the samples currently held.
+	 *
+	 * @param OutSamples Receives the samples, oldest first.
+	 */
+	void Snapshot(TArray<FNeuroStrikeLatencySample>& OutSamples) const;
+
+private:
+	/** The samples, allocated to the full capacity up front. */
+	TArray<FNeuroStrikeLatencySample> Slots;
+
+	/** Capacity minus one, masking write indices into slots. */
+	uint32 Mask = 0;
+
+	/** Index of the next slot to write, counting every sample ever pushed. */
+	uint32 WriteIndex = 0;
+};
+
+/**
+ * World subsystem that measures the latency from a trigger pull to its hit.
+ *
+ * Markers are taken where a shot goes through the game: at Fire on the owning client, when the server processes
+ * ServerStartFiring, when it runs Shoot, around HandleProjectile, when the projectile or trace hits, and when the
+ * resulting health drop is replicated back to the shooter. Each span between two markers is recorded into a
+ * per-player ring, on the server for server-side spans and on the shooter's client for FireToHealth. Times that
+ * cross the network are compared in the server's clock, as estimated by clients; estimation errors can make such
+ * spans negative, and those are counted apart instead of being mixed into the percentiles.
+ *
+ * NeuroStrike.Latency.Report logs the p50, p95 and p99 of every span; every CsvDumpInterval seconds, they are also
+ * appended to a CSV file in the profiling directory when enabled in config or with -NeuroStrikeLatencyCsv.
+ *
+ * FireToHealth needs the victim of every local shot, which costs hitscan weapons an extra trace per bullet, so it
+ * is only measured while enabled through bMeasureFireToHealth or the CSV dump. Projectile weapons take their
+ * victim from the predicted projectile's hit instead; swarm pellets are not attributed.
+ *
+ * Every marker is taken on the game thread, and the subsystem is not thread-safe.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikeLatencySubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	UNeuroStrikeLatencySubsystem();
+	virtual ~UNeuroStrikeLatencySubsystem() override;
+
+	/** Enables the periodic CSV dump if requested in config or with -NeuroStrikeLatencyCsv. */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Writes a last CSV dump if the periodic dump is enabled. */
+	virtual void Deinitialize() override;
+
+	/**
+	 * Appends the percentiles of every player to the CSV file once CsvDumpInterval has elapsed.
+	 *
+	 * @param DeltaTime Time elapsed since the previous frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Records a span of a player's shot.
+	 *
+	 * @param Shooter The pawn that fired. Ignored if it has no player state.
+	 * @param Span The span measured.
+	 * @param Seconds Duration of the span. Negative durations, caused by clock estimation, are only counted.
+	 */
+	void RecordSpan(const APawn* Shooter, ENeuroStrikeLatencySpan Span, double Seconds);
+
+	/**
+	 * Checks whether FireToHealth is measured, so shot sources can skip finding the victim of their shots.
+	 *
+	 * @return true if FireToHealth was enabled in config or by the CSV dump.
+	 */
+	bool IsFireToHealthEnabled() const {
+		return this->bFireToHealthEnabled;
+	}
+
+	/**
+	 * Remembers the latest shot fired by a locally controlled character at another character, to measure
+	 * FireToHealth. Clients only.
+	 *
+	 * @param Shooter The local pawn that fired.
+	 * @param ShotTime The time of the shot, in the server's clock as estimated by the client.
+	 * @param Victim The character the shot hit, as predicted by the shooter.
+	 */
+	void NotifyLocalShot(const APawn* Shooter, float ShotTime, const AActor* Victim);
+
+	/**
+	 * Records FireToHealth for every local shooter that recently fired at a character whose replicated health
+	 * just dropped. Clients only.
+	 *
+	 * @param Victim The character whose health dropped.
+	 */
+	void NotifyRemoteHealthDropped(const AActor* Victim);
+
+	/** Logs the sample count, negative span count, p50, p95 and p99 of every span of every player. */
+	void LogReport() const;
+
+	/** Appends the sample count, negative span count, p50, p95 and p99 of every span of every player to the CSV. */
+	void DumpCsv();
+
+	/** Samples kept per player, rounded up to a power of two. */
+	UPROPERTY(config)
+	int32 SamplesPerPlayer = 1024;
+
+	/** Whether every game and PIE world dumps percentiles to CSV on its own. */
+	UPROPERTY(config)
+	bool bDumpCsvByDefault = false;
+
+	/** Seconds between two CSV dumps. */
+	UPROPERTY(config)
+	float CsvDumpInterval = 10.0f;
+
+	/** Whether FireToHealth is measured in every game and PIE world, even without the CSV dump. */
+	UPROPERTY(config)
+	bool bMeasureFireToHealth = false;
+
+	/** Longest time after a local shot that a health drop of another character is attributed to it, in seconds. */
+	UPROPERTY(config)
+	float MaxHitAttributionTime = 1.0f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Samples of a player, with the name they are reported under. */
+	struct FPlayerLatency {
+		FString Name;
+		TUniquePtr<FNeuroStrikeLatencyRing> Ring;
+
+		/** Negative spans recorded for the player, by span. They are not part of the ring. */
+		int32 NegativeSpans[static_cast<int32>(ENeuroStrikeLatencySpan::Count)] = {};
+	};
+
+	/** The latest shot of a local shooter, with the character it was aimed at. */
+	struct FLocalShot {
+		float ShotTime = 0.0f;
+		TWeakObjectPtr<const AActor> Victim;
+	};
+
+	/**
+	 * Computes the sample count, negative span count, p50, p95 and p99 of every span of a player.
+	 *
+	 * @param Player The player's samples.
+	 * @param Visitor Called with the span, sample count, negative span count and percentiles of every span with
+	 *                samples or negative spans. Percentiles are zero without samples.
+	 */
+	static void ForEachSpanSummary(
+		const FPlayerLatency& Player,
+		TFunctionRef<void(ENeuroStrikeLatencySpan, int32, int32, float, float, float)> Visitor);
+
+	/** Samples of every player, by player id. */
+	TMap<int32, FPlayerLatency> Players;
+
+	/** Latest shot of every local shooter, by player id. */
+	TMap<int32, FLocalShot> LocalShots;
+
+	/** CSV file percentiles are appended to, empty while the periodic dump is disabled. */
+	FString CsvPath;
+
+	/** Time left until the next CSV dump. */
+	float TimeUntilCsvDump = 0.0f;
+
+	/** Whether local shots look for their victim to measure FireToHealth. */
+	bool bFireToHealthEnabled = false;
+};
@@ -0,0 +1,639 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeMatchRecorderSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "NeuroStrikeLagCompensationSubsystem.h"
+#include "NeuroStrikeMovementComponent.h"
+#include "Containers/Queue.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/BitReader.h"
+#include <atomic>
+
+namespace NeuroStrikeMatchRecorder {
+	/** Magic number at the start of every recording. */
+	constexpr uint32 FileMagic = 0x3152534E; // "NSR1"
+
+	/** Magic number closing the keyframe index at the end of a complete recording. */
+	constexpr uint32 IndexMagic = 0x5849534E; // "NSIX"
+
+	/** Version of the snapshot encoding. */
+	constexpr uint16 FileVersion = 1;
+
+	/** Bits of the character field mask. */
+	constexpr uint32 FieldLocation = 1 << 0;
+	constexpr uint32 FieldAim = 1 << 1;
+	constexpr uint32 FieldHealth = 1 << 2;
+	constexpr uint32 FieldStamina = 1 << 3;
+	constexpr uint32 FieldFlags = 1 << 4;
+	constexpr uint32 AllFields = (1 << 5) - 1;
+
+	/**
+	 * Maps signed values to unsigned ones so that small magnitudes of either sign pack into few bits.
+	 *
+	 * @param Value The signed value.
+	 * @return The zigzag encoded value.
+	 */
+	static uint32 ZigZag(int32 Value) {
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	/**
+	 * Rounds a world location to whole centimeters.
+	 *
+	 * @param Location The world location.
+	 * @return The quantized location.
+	 */
+	static FIntVector QuantizeLocation(const FVector& Location) {
+		return FIntVector(FMath::RoundToInt(Location.X), FMath::RoundToInt(Location.Y), FMath::RoundToInt(Location.Z));
+	}
+
+	/**
+	 * Packs a location, either absolute or relative to a previous one.
+	 *
+	 * @param Bits The writer to pack into.
+	 * @param Location The location to write.
+	 * @param Base The location it is relative to.
+	 */
+	static void WriteLocation(FBitWriter& Bits, const FIntVector& Location, const FIntVector& Base) {
+		for (int32 Axis = 0; Axis < 3; ++Axis) {
+			uint32 Packed = ZigZag(Location[Axis] - Base[Axis]);
+			Bits.SerializeIntPacked(Packed);
+		}
+	}
+
+	/**
+	 * Appends raw bytes to a buffer.
+	 *
+	 * @param Buffer The buffer to append to.
+	 * @param Value The value whose bytes are appended.
+	 */
+	template <typename T>
+	static void AppendRaw(TArray<uint8>& Buffer, const T& Value) {
+		Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+
+	/**
+	 * Reads raw bytes from a buffer.
+	 *
+	 * @param Bytes The buffer to read from.
+	 * @param Offset Offset of the value in the buffer. Must leave room for the whole value.
+	 * @return The value.
+	 */
+	template <typename T>
+	static T ReadRaw(const TArray<uint8>& Bytes, int64 Offset) {
+		T Value;
+		FMemory::Memcpy(&Value, Bytes.GetData() + Offset, sizeof(T));
+		return Value;
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs StartCommand(
+		TEXT("NeuroStrike.Recorder.Start"),
+		TEXT("Starts recording the current match on the server. Optionally takes the file to record into."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World) {
+			if (World != nullptr) {
+				if (UNeuroStrikeMatchRecorderSubsystem* Recorder = World->GetSubsystem<
+					UNeuroStrikeMatchRecorderSubsystem>()) {
+					Recorder->StartRecording(Args.Num() > 0 ? Args[0] : FString());
+				}
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorld StopCommand(
+		TEXT("NeuroStrike.Recorder.Stop"),
+		TEXT("Stops recording the current match and closes the recording file."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World) {
+			if (World != nullptr) {
+				if (UNeuroStrikeMatchRecorderSubsystem* Recorder = World->GetSubsystem<
+					UNeuroStrikeMatchRecorderSubsystem>()) {
+					Recorder->StopRecording();
+				}
+			}
+		}));
+
+	static FAutoConsoleCommandWithArgs VerifyCommand(
+		TEXT("NeuroStrike.Recorder.Verify"),
+		TEXT("Reads a finished match recording back and checks its snapshots against its keyframe index."),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+			if (Args.Num() > 0) {
+				UNeuroStrikeMatchRecorderSubsystem::VerifyRecording(Args[0]);
+			}
+		}));
+}
+
+/**
+ * Background thread appending recording buffers to their file in the order they were queued.
+ */
+class FNeuroStrikeRecordingWriter final : public FRunnable {
+public:
+	/**
+	 * Starts the writer thread.
+	 *
+	 * @param InFile The file to append to. Owned and closed by the writer.
+	 */
+	explicit FNeuroStrikeRecordingWriter(IFileHandle* InFile)
+		: File(InFile), WakeEvent(FPlatformProcess::GetSynchEventFromPool(false)) {
+		this->Thread = FRunnableThread::Create(this, TEXT("NeuroStrikeRecordingWriter"), 0, TPri_BelowNormal);
+	}
+
+	/** Writes every queued buffer, then stops the thread and closes the file. */
+	virtual ~FNeuroStrikeRecordingWriter() override {
+		if (this->Thread != nullptr) {
+			this->Thread->Kill(true);
+			delete this->Thread;
+		}
+
+		this->WriteQueued();
+		FPlatformProcess::ReturnSynchEventToPool(this->WakeEvent);
+	}
+
+	/**
+	 * Queues a buffer to be appended to the file. Game thread only.
+	 *
+	 * @param Bytes The buffer, moved to the writer thread.
+	 */
+	void Enqueue(TArray<uint8>&& Bytes) {
+		this->Queue.Enqueue(MoveTemp(Bytes));
+		this->WakeEvent->Trigger();
+	}
+
+	virtual uint32 Run() override {
+		while (!this->bStopping) {
+			this->WakeEvent->Wait();
+			this->WriteQueued();
+		}
+
+		this->WriteQueued();
+		return 0;
+	}
+
+	virtual void Stop() override {
+		this->bStopping = true;
+		this->WakeEvent->Trigger();
+	}
+
+private:
+	/** Appends every queued buffer to the file. */
+	void WriteQueued() {
+		TArray<uint8> Bytes;
+		while (this->Queue.Dequeue(Bytes)) {
+			if (!this->File->Write(Bytes.GetData(), Bytes.Num()) && !this->bWriteFailed) {
+				this->bWriteFailed = true;
+				UE_LOG(LogNeuroStrike, Error, TEXT("Failed to write match recording, the file will be truncated"));
+			}
+		}
+		this->File->Flush();
+	}
+
+	/** The recording file. */
+	TUniquePtr<IFileHandle> File;
+
+	/** Signalled whenever a buffer is queued or the thread has to stop. */
+	FEvent* WakeEvent;
+
+	/** The thread running Run. */
+	FRunnableThread* Thread = nullptr;
+
+	/** Buffers waiting to be written, produced by the game thread and consumed by the writer thread. */
+	TQueue<TArray<uint8>, EQueueMode::Spsc> Queue;
+
+	/** Set when the writer thread has to exit once the queue is empty. */
+	std::atomic<bool> bStopping = false;
+
+	/** Set after the first failed write, so the error is only logged once. */
+	bool bWriteFailed = false;
+};
+
+UNeuroStrikeMatchRecorderSubsystem::UNeuroStrikeMatchRecorderSubsystem() = default;
+
+UNeuroStrikeMatchRecorderSubsystem::~UNeuroStrikeMatchRecorderSubsystem() = default;
+
+bool UNeuroStrikeMatchRecorderSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UNeuroStrikeMatchRecorderSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNeuroStrikeMatchRecorderSubsystem, STATGROUP_NeuroStrike);
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::OnWorldBeginPlay(UWorld& InWorld) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() != NM_Client
+		&& (this->bRecordByDefault || FParse::Param(FCommandLine::Get(), TEXT("NeuroStrikeRecord")))) {
+		this->StartRecording();
+	}
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::Deinitialize() {
+	this->StopRecording();
+
+	Super::Deinitialize();
+}
+
+UNeuroStrikeMatchRecorderSubsystem* UNeuroStrikeMatchRecorderSubsystem::GetActive(const UWorld* World) {
+	UNeuroStrikeMatchRecorderSubsystem* Recorder = World != nullptr
+		                                               ? World->GetSubsystem<UNeuroStrikeMatchRecorderSubsystem>()
+		                                               : nullptr;
+	return Recorder != nullptr && Recorder->IsRecording() ? Recorder : nullptr;
+}
+
+bool UNeuroStrikeMatchRecorderSubsystem::VerifyRecording(const FString& Filename) {
+	using namespace NeuroStrikeMatchRecorder;
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename)) {
+		UE_LOG(LogNeuroStrike, Error, TEXT("Could not read match recording %s"), *Filename);
+		return false;
+	}
+
+	constexpr int64 CountSize = sizeof(uint32);
+	constexpr int64 HeaderSize = sizeof(uint32) + sizeof(uint16);
+	constexpr int64 EntrySize = sizeof(float) + sizeof(uint64);
+	constexpr int64 TrailerSize = sizeof(uint64) + sizeof(uint32);
+	const int64 Size = Bytes.Num();
+	if (Size < HeaderSize || ReadRaw<uint32>(Bytes, 0) != FileMagic) {
+		UE_LOG(LogNeuroStrike, Error, TEXT("%s is not a match recording"), *Filename);
+		return false;
+	}
+	if (ReadRaw<uint16>(Bytes, sizeof(uint32)) != FileVersion) {
+		UE_LOG(LogNeuroStrike, Error, TEXT("%s has an unsupported recording version"), *Filename);
+		return false;
+	}
+	if (Size < HeaderSize + CountSize + TrailerSize || ReadRaw<uint32>(Bytes, Size - sizeof(uint32)) != IndexMagic) {
+		UE_LOG(LogNeuroStrike, Error, TEXT("%s has no keyframe index, the recording was not stopped"), *Filename);
+		return false;
+	}
+
+	const uint64 StoredIndexOffset = ReadRaw<uint64>(Bytes, Size - TrailerSize);
+	const int64 IndexOffset = StoredIndexOffset <= static_cast<uint64>(Size - TrailerSize - CountSize)
+		                          ? static_cast<int64>(StoredIndexOffset)
+		                          : -1;
+	const int64 NumEntries = IndexOffset >= HeaderSize ? ReadRaw<uint32>(Bytes, IndexOffset) : -1;
+	if (NumEntries < 0 || IndexOffset + CountSize + NumEntries * EntrySize + TrailerSize != Size) {
+		UE_LOG(LogNeuroStrike, Error, TEXT("%s has a corrupt keyframe index"), *Filename);
+		return false;
+	}
+
+	// Every snapshot must fit between the header and the index, and every keyframe must be listed in order.
+	int64 Offset = HeaderSize;
+	int64 NumSnapshots = 0;
+	int64 NumKeyframes = 0;
+	while (Offset + CountSize <= IndexOffset) {
+		const uint32 NumBits = ReadRaw<uint32>(Bytes, Offset);
+		const int64 NumBytes = (static_cast<int64>(NumBits) + 7) / 8;
+		if (NumBits < 1 + 32 || Offset + CountSize + NumBytes > IndexOffset) {
+			break;
+		}
+
+		FBitReader Bits(Bytes.GetData() + Offset + CountSize, NumBits);
+		const bool bKeyframe = Bits.ReadBit() != 0;
+		float Time = 0.0f;
+		Bits << Time;
+
+		if (bKeyframe) {
+			const int64 EntryOffset = IndexOffset + CountSize + NumKeyframes * EntrySize;
+			if (NumKeyframes >= NumEntries
+				|| ReadRaw<float>(Bytes, EntryOffset) != Time
+				|| static_cast<int64>(ReadRaw<uint64>(Bytes, EntryOffset + sizeof(float))) != Offset) {
+				UE_LOG(LogNeuroStrike, Error, TEXT("%s: keyframe %lld at offset %lld is not in the index"),
+				       *Filename, NumKeyframes, Offset);
+				return false;
+			}
+			++NumKeyframes;
+		}
+
+		++NumSnapshots;
+		Offset += CountSize + NumBytes;
+	}
+
+	if (Offset != IndexOffset) {
+		UE_LOG(LogNeuroStrike, Error, TEXT("%s: snapshot %lld at offset %lld is corrupt"), *Filename, NumSnapshots,
+		       Offset);
+		return false;
+	}
+	if (NumKeyframes != NumEntries) {
+		UE_LOG(LogNeuroStrike, Error, TEXT("%s: the index lists %lld keyframes but the file holds %lld"), *Filename,
+		       NumEntries, NumKeyframes);
+		return false;
+	}
+
+	UE_LOG(LogNeuroStrike, Log, TEXT("%s is valid: %lld snapshots, %lld keyframes"), *Filename, NumSnapshots,
+	       NumKeyframes);
+	return true;
+}
+
+bool UNeuroStrikeMatchRecorderSubsystem::StartRecording(const FString& Filename) {
+	const UWorld* World = this->GetWorld();
+	if (this->IsRecording() || World == nullptr || World->GetNetMode() == NM_Client) {
+		return false;
+	}
+
+	FString Path = Filename;
+	if (Path.IsEmpty()) {
+		Path = FPaths::ProfilingDir() / TEXT("Recordings") / FString::Printf(
+			TEXT("%s_%s.nsrec"), *World->GetMapName(), *FDateTime::Now().ToString());
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+	IFileHandle* File = PlatformFile.OpenWrite(*Path);
+	if (File == nullptr) {
+		UE_LOG(LogNeuroStrike, Error, TEXT("Could not open match recording %s"), *Path);
+		return false;
+	}
+
+	this->Writer = MakeUnique<FNeuroStrikeRecordingWriter>(File);
+	this->BytesFlushed = 0;
+	this->NextId = 1;
+	this->LastKeyframeTime = -1.0f;
+
+	this->Buffer.Reset();
+	this->Buffer.Reserve(this->FlushSize + 4096);
+	NeuroStrikeMatchRecorder::AppendRaw(this->Buffer, NeuroStrikeMatchRecorder::FileMagic);
+	NeuroStrikeMatchRecorder::AppendRaw(this->Buffer, NeuroStrikeMatchRecorder::FileVersion);
+
+	UE_LOG(LogNeuroStrike, Log, TEXT("Recording match to %s"), *Path);
+	return true;
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::StopRecording() {
+	if (!this->IsRecording()) {
+		return;
+	}
+
+	const uint64 IndexOffset = this->BytesFlushed + this->Buffer.Num();
+	NeuroStrikeMatchRecorder::AppendRaw(this->Buffer, static_cast<uint32>(this->KeyframeIndex.Num()));
+	for (const TPair<float, uint64>& Keyframe : this->KeyframeIndex) {
+		NeuroStrikeMatchRecorder::AppendRaw(this->Buffer, Keyframe.Key);
+		NeuroStrikeMatchRecorder::AppendRaw(this->Buffer, Keyframe.Value);
+	}
+	NeuroStrikeMatchRecorder::AppendRaw(this->Buffer, IndexOffset);
+	NeuroStrikeMatchRecorder::AppendRaw(this->Buffer, NeuroStrikeMatchRecorder::IndexMagic);
+
+	this->FlushBuffer();
+	this->Writer.Reset();
+
+	UE_LOG(LogNeuroStrike, Log, TEXT("Match recording finished: %llu bytes, %d keyframes"), this->BytesFlushed,
+	       this->KeyframeIndex.Num());
+
+	this->RecordedCharacters.Empty();
+	this->CharacterIndices.Empty();
+	this->RemovedIds.Empty();
+	this->PendingEvents.Empty();
+	this->KeyframeIndex.Empty();
+	this->Buffer.Empty();
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	if (!this->IsRecording()) {
+		return;
+	}
+
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Recorder Snapshot", STAT_NeuroStrike_RecorderSnapshot);
+
+	const float Now = this->GetWorld()->GetTimeSeconds();
+	const bool bKeyframe = this->LastKeyframeTime < 0.0f || Now - this->LastKeyframeTime >= this->KeyframeInterval;
+
+	this->GatherCharacters();
+	this->WriteSnapshot(Now, bKeyframe);
+
+	if (this->Buffer.Num() >= this->FlushSize) {
+		this->FlushBuffer();
+	}
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::RecordShot(const ANeuroStrikeCharacter* Shooter, uint16 ShotId) {
+	FRecordedEvent& Event = this->PendingEvents.AddDefaulted_GetRef();
+	Event.Type = EEventType::Shot;
+	Event.InstigatorId = this->FindOrAddId(Shooter);
+	Event.ShotId = ShotId;
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::RecordProjectileLaunch(const AActor* Instigator, const FVector& Location,
+                                                                const FVector& Direction, uint16 ShotId) {
+	const FRotator Rotation = Direction.Rotation();
+
+	FRecordedEvent& Event = this->PendingEvents.AddDefaulted_GetRef();
+	Event.Type = EEventType::ProjectileLaunch;
+	Event.InstigatorId = this->FindOrAddId(Instigator);
+	Event.ShotId = ShotId;
+	Event.Location = NeuroStrikeMatchRecorder::QuantizeLocation(Location);
+	Event.Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+	Event.Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::RecordProjectileHit(const AActor* Instigator, const FVector& Location,
+                                                             uint16 ShotId) {
+	FRecordedEvent& Event = this->PendingEvents.AddDefaulted_GetRef();
+	Event.Type = EEventType::ProjectileHit;
+	Event.InstigatorId = this->FindOrAddId(Instigator);
+	Event.ShotId = ShotId;
+	Event.Location = NeuroStrikeMatchRecorder::QuantizeLocation(Location);
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::RecordDamage(const AActor* Instigator, const ANeuroStrikeCharacter* Victim,
+                                                      float Amount) {
+	FRecordedEvent& Event = this->PendingEvents.AddDefaulted_GetRef();
+	Event.Type = EEventType::Damage;
+	Event.InstigatorId = this->FindOrAddId(Instigator);
+	Event.VictimId = this->FindOrAddId(Victim);
+	Event.Amount = static_cast<uint32>(FMath::RoundToInt(FMath::Max(Amount, 0.0f) * 100.0f));
+}
+
+UNeuroStrikeMatchRecorderSubsystem::FRecordedState UNeuroStrikeMatchRecorderSubsystem::CaptureState(
+	const ANeuroStrikeCharacter& Character) {
+	const FRotator Aim = Character.GetBaseAimRotation();
+
+	FRecordedState State;
+	State.Location = NeuroStrikeMatchRecorder::QuantizeLocation(Character.GetActorLocation());
+	State.Yaw = FRotator::CompressAxisToShort(Aim.Yaw);
+	State.Pitch = FRotator::CompressAxisToShort(Aim.Pitch);
+	State.Health = FNeuroStrikeMovementState::Quantize(Character.Health, Character.MaxHealth);
+	State.Stamina = FNeuroStrikeMovementState::Quantize(Character.GetStamina(), Character.MaxStamina);
+	State.Flags = (Character.GetNeuroStrikeMovement()->IsSprinting() ? 1 : 0) | (Character.IsDead() ? 2 : 0);
+	return State;
+}
+
+uint32 UNeuroStrikeMatchRecorderSubsystem::FindOrAddId(const AActor* Actor) {
+	ANeuroStrikeCharacter* Character = const_cast<ANeuroStrikeCharacter*>(Cast<ANeuroStrikeCharacter>(Actor));
+	if (!IsValid(Character)) {
+		return 0;
+	}
+
+	const int32* Index = this->CharacterIndices.Find(Character);
+	return Index != nullptr ? this->RecordedCharacters[*Index].Id : this->AddCharacter(Character);
+}
+
+uint32 UNeuroStrikeMatchRecorderSubsystem::AddCharacter(ANeuroStrikeCharacter* Character) {
+	FRecordedCharacter& Recorded = this->RecordedCharacters.AddDefaulted_GetRef();
+	Recorded.Character = Character;
+	Recorded.Id = this->NextId++;
+	this->CharacterIndices.Add(Character, this->RecordedCharacters.Num() - 1);
+	return Recorded.Id;
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::GatherCharacters() {
+	bool bRemoved = false;
+	for (int32 Index = this->RecordedCharacters.Num() - 1; Index >= 0; --Index) {
+		if (!this->RecordedCharacters[Index].Character.IsValid()) {
+			this->RemovedIds.Add(this->RecordedCharacters[Index].Id);
+			this->RecordedCharacters.RemoveAtSwap(Index, 1, false);
+			bRemoved = true;
+		}
+	}
+
+	if (bRemoved) {
+		this->CharacterIndices.Reset();
+		for (int32 Index = 0; Index < this->RecordedCharacters.Num(); ++Index) {
+			this->CharacterIndices.Add(this->RecordedCharacters[Index].Character.Get(), Index);
+		}
+	}
+
+	// The lag compensation subsystem already tracks every server-side character.
+	const UNeuroStrikeLagCompensationSubsystem* LagCompensation = this->GetWorld()->GetSubsystem<
+		UNeuroStrikeLagCompensationSubsystem>();
+	if (LagCompensation == nullptr) {
+		return;
+	}
+
+	for (const TWeakObjectPtr<ANeuroStrikeCharacter>& Character : LagCompensation->GetCharacters()) {
+		ANeuroStrikeCharacter* TrackedCharacter = Character.Get();
+		if (TrackedCharacter != nullptr && !this->CharacterIndices.Contains(TrackedCharacter)) {
+			this->AddCharacter(TrackedCharacter);
+		}
+	}
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::WriteSnapshot(float Time, bool bKeyframe) {
+	using namespace NeuroStrikeMatchRecorder;
+
+	FBitWriter& Bits = this->SnapshotBits;
+	Bits.Reset();
+
+	uint8 KeyframeBit = bKeyframe ? 1 : 0;
+	Bits.WriteBit(KeyframeBit);
+	Bits << Time;
+
+	// A keyframe lists every character, so readers seeking to it need no removals from earlier snapshots.
+	uint32 NumRemoved = bKeyframe ? 0 : this->RemovedIds.Num();
+	Bits.SerializeIntPacked(NumRemoved);
+	for (uint32 Index = 0; Index < NumRemoved; ++Index) {
+		Bits.SerializeIntPacked(this->RemovedIds[Index]);
+	}
+	this->RemovedIds.Reset();
+
+	TArray<TPair<int32, uint32>, TInlineAllocator<64>> Changes;
+	TArray<FRecordedState, TInlineAllocator<64>> States;
+	for (int32 Index = 0; Index < this->RecordedCharacters.Num(); ++Index) {
+		const FRecordedCharacter& Recorded = this->RecordedCharacters[Index];
+		const FRecordedState State = CaptureState(*Recorded.Character.Get());
+		const FRecordedState& Old = Recorded.State;
+
+		uint32 Fields = AllFields;
+		if (!bKeyframe && !Recorded.bNew) {
+			Fields = (State.Location != Old.Location ? FieldLocation : 0)
+				| (State.Yaw != Old.Yaw || State.Pitch != Old.Pitch ? FieldAim : 0)
+				| (State.Health != Old.Health ? FieldHealth : 0)
+				| (State.Stamina != Old.Stamina ? FieldStamina : 0)
+				| (State.Flags != Old.Flags ? FieldFlags : 0);
+		}
+
+		if (Fields != 0) {
+			Changes.Emplace(Index, Fields);
+			States.Add(State);
+		}
+	}
+
+	uint32 NumChanges = Changes.Num();
+	Bits.SerializeIntPacked(NumChanges);
+	for (int32 ChangeIndex = 0; ChangeIndex < Changes.Num(); ++ChangeIndex) {
+		FRecordedCharacter& Recorded = this->RecordedCharacters[Changes[ChangeIndex].Key];
+		uint32 Fields = Changes[ChangeIndex].Value;
+		FRecordedState& State = States[ChangeIndex];
+		const bool bFull = Fields == AllFields;
+
+		Bits.SerializeIntPacked(Recorded.Id);
+		Bits.SerializeInt(Fields, AllFields + 1);
+
+		if (Fields & FieldLocation) {
+			// Full states are absolute so the snapshot decodes without the previous one.
+			WriteLocation(Bits, State.Location, bFull ? FIntVector::ZeroValue : Recorded.State.Location);
+		}
+		if (Fields & FieldAim) {
+			Bits << State.Yaw << State.Pitch;
+		}
+		if (Fields & FieldHealth) {
+			Bits << State.Health;
+		}
+		if (Fields & FieldStamina) {
+			Bits << State.Stamina;
+		}
+		if (Fields & FieldFlags) {
+			uint32 Flags = State.Flags;
+			Bits.SerializeInt(Flags, 4);
+		}
+
+		Recorded.State = State;
+		Recorded.bNew = false;
+	}
+
+	uint32 NumEvents = this->PendingEvents.Num();
+	Bits.SerializeIntPacked(NumEvents);
+	for (FRecordedEvent& Event : this->PendingEvents) {
+		uint32 Type = static_cast<uint32>(Event.Type);
+		Bits.SerializeInt(Type, static_cast<uint32>(EEventType::Count));
+		Bits.SerializeIntPacked(Event.InstigatorId);
+
+		switch (Event.Type) {
+		case EEventType::Shot:
+			Bits << Event.ShotId;
+			break;
+		case EEventType::ProjectileLaunch:
+			Bits << Event.ShotId;
+			WriteLocation(Bits, Event.Location, FIntVector::ZeroValue);
+			Bits << Event.Yaw << Event.Pitch;
+			break;
+		case EEventType::ProjectileHit:
+			Bits << Event.ShotId;
+			WriteLocation(Bits, Event.Location, FIntVector::ZeroValue);
+			break;
+		case EEventType::Damage:
+			Bits.SerializeIntPacked(Event.VictimId);
+			Bits.SerializeIntPacked(Event.Amount);
+			break;
+		default:
+			break;
+		}
+	}
+	this->PendingEvents.Reset();
+
+	if (bKeyframe) {
+		this->KeyframeIndex.Emplace(Time, this->BytesFlushed + this->Buffer.Num());
+		this->LastKeyframeTime = Time;
+	}
+
+	AppendRaw(this->Buffer, static_cast<uint32>(Bits.GetNumBits()));
+	this->Buffer.Append(Bits.GetData(), Bits.GetNumBytes());
+}
+
+void UNeuroStrikeMatchRecorderSubsystem::FlushBuffer() {
+	if (this->Buffer.Num() == 0 || !this->Writer.IsValid()) {
+		return;
+	}
+
+	this->BytesFlushed += this->Buffer.Num();
+	this->Writer->Enqueue(MoveTemp(this->Buffer));
+
+	this->Buffer = TArray<uint8>();
+	this->Buffer.Reserve(this->FlushSize + 4096);
+}
@@ -0,0 +1,271 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Serialization/BitWriter.h"
+#include "UObject/ObjectKey.h"
+#include "NeuroStrikeMatchRecorderSubsystem.generated.h"
+
+class ANeuroStrikeCharacter;
+class FNeuroStrikeRecordingWriter;
+
+/**
+ * Server-side subsystem that records a match into a compact, append-only file for offline review.
+ *
+ * Every server frame the authoritative state of every character (location, aim, health, stamina, sprint and
+ * death) is quantized and bit-packed into a snapshot, together with the shots, projectile launches, projectile
+ * hits and damage events of the frame. Snapshots only hold what changed since the previous one; every
+ * KeyframeInterval seconds a keyframe holds the full state instead, so a reader can seek to any keyframe and
+ * decode from there.
+ *
+ * Snapshots are appended to an in-memory buffer on the game thread. Full buffers are handed to a background
+ * thread that writes them to disk, so the game thread never waits for the file system.
+ *
+ * File layout, all little endian:
+ *   Header:   uint32 magic 'NSR1', uint16 version.
+ *   Snapshot: uint32 payload bits, payload bytes. The payload starts with a keyframe bit and the server time.
+ *   Trailer:  keyframe index (uint32 count, then float time and uint64 file offset of each keyframe), uint64
+ *             offset of the index and uint32 magic 'NSIX'. Only written when the recording is stopped, so a
+ *             truncated file can still be read by walking the snapshots from the header.
+ *
+ * NeuroStrike.Recorder.Verify walks a finished recording and checks its keyframe index against the snapshots.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikeMatchRecorderSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	UNeuroStrikeMatchRecorderSubsystem();
+	virtual ~UNeuroStrikeMatchRecorderSubsystem() override;
+
+	/** Starts recording right away if recording is enabled in config or with -NeuroStrikeRecord. */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Stops the current recording and waits for its last buffer to be written. */
+	virtual void Deinitialize() override;
+
+	/**
+	 * Captures the snapshot of the frame.
+	 *
+	 * @param DeltaTime Time elapsed since the previous frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Opens a new recording file and starts capturing snapshots. Authority only.
+	 *
+	 * @param Filename File to record into. Defaults to a timestamped file in the profiling directory.
+	 * @return true if the file could be opened.
+	 */
+	bool StartRecording(const FString& Filename = FString());
+
+	/** Writes the keyframe index and closes the recording file. */
+	void StopRecording();
+
+	/**
+	 * Checks whether a recording is in progress.
+	 *
+	 * @return true between StartRecording and StopRecording.
+	 */
+	bool IsRecording() const {
+		return this->Writer.IsValid();
+	}
+
+	/**
+	 * Retrieves the recorder of a world, but only while it is recording, so event sources can skip all
+	 * recording work with a single check.
+	 *
+	 * @param World The world to look in.
+	 * @return The recording subsystem, or nullptr if the world is not being recorded.
+	 */
+	static UNeuroStrikeMatchRecorderSubsystem* GetActive(const UWorld* World);
+
+	/**
+	 * Reads a finished recording back and checks that it is well formed: the header, the framing of every
+	 * snapshot and the keyframe index, whose every entry must point at a keyframe snapshot of the same time.
+	 *
+	 * @param Filename The recording to check.
+	 * @return true if the recording is complete and consistent. Problems are logged.
+	 */
+	static bool VerifyRecording(const FString& Filename);
+
+	/**
+	 * Records a shot fired with authority.
+	 *
+	 * @param Shooter The character that fired.
+	 * @param ShotId Sequence number of the shot.
+	 */
+	void RecordShot(const ANeuroStrikeCharacter* Shooter, uint16 ShotId);
+
+	/**
+	 * Records an authoritative projectile leaving the muzzle.
+	 *
+	 * @param Instigator The character that fired the projectile, if any.
+	 * @param Location World location the projectile starts from.
+	 * @param Direction Direction the projectile travels in.
+	 * @param ShotId Sequence number of the shot that launched it.
+	 */
+	void RecordProjectileLaunch(const AActor* Instigator, const FVector& Location, const FVector& Direction,
+	                            uint16 ShotId);
+
+	/**
+	 * Records an authoritative projectile hitting something.
+	 *
+	 * @param Instigator The character that fired the projectile, if any.
+	 * @param Location World location of the impact.
+	 * @param ShotId Sequence number of the shot that launched it.
+	 */
+	void RecordProjectileHit(const AActor* Instigator, const FVector& Location, uint16 ShotId);
+
+	/**
+	 * Records damage applied to a character.
+	 *
+	 * @param Instigator The character credited for the damage, if any.
+	 * @param Victim The damaged character.
+	 * @param Amount The health removed.
+	 */
+	void RecordDamage(const AActor* Instigator, const ANeuroStrikeCharacter* Victim, float Amount);
+
+	/** Whether every game and PIE server starts recording on its own. */
+	UPROPERTY(config)
+	bool bRecordByDefault = false;
+
+	/** Seconds between two keyframes. Shorter intervals make seeking faster and files bigger. */
+	UPROPERTY(config)
+	float KeyframeInterval = 5.0f;
+
+	/** Size in bytes the snapshot buffer reaches before it is handed to the writer thread. */
+	UPROPERTY(config)
+	int32 FlushSize = 64 * 1024;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Quantized state of a character as written to the recording. */
+	struct FRecordedState {
+		/** Location in whole centimeters. */
+		FIntVector Location = FIntVector::ZeroValue;
+
+		/** Aim compressed with FRotator::CompressAxisToShort. */
+		uint16 Yaw = 0;
+		uint16 Pitch = 0;
+
+		/** Health and stamina quantized like the replicated movement state. */
+		uint8 Health = 0;
+		uint8 Stamina = 0;
+
+		/** Bit 0: sprinting, bit 1: dead. */
+		uint8 Flags = 0;
+	};
+
+	/** A character being recorded and the state last written for it. */
+	struct FRecordedCharacter {
+		TWeakObjectPtr<ANeuroStrikeCharacter> Character;
+
+		/** Identifier of the character in the recording. Never reused within a file; zero means none. */
+		uint32 Id = 0;
+
+		FRecordedState State;
+
+		/** Whether the character has not been written yet and needs its full state. */
+		bool bNew = true;
+	};
+
+	/** Kinds of events recorded alongside the snapshots. */
+	enum class EEventType : uint8 {
+		Shot,
+		ProjectileLaunch,
+		ProjectileHit,
+		Damage,
+		Count
+	};
+
+	/** A gameplay event waiting for the snapshot of its frame. */
+	struct FRecordedEvent {
+		EEventType Type = EEventType::Shot;
+		uint32 InstigatorId = 0;
+		uint32 VictimId = 0;
+		uint16 ShotId = 0;
+		FIntVector Location = FIntVector::ZeroValue;
+		uint16 Yaw = 0;
+		uint16 Pitch = 0;
+		uint32 Amount = 0;
+	};
+
+	/**
+	 * Quantizes the current state of a character.
+	 *
+	 * @param Character The character to capture.
+	 * @return The state as it is written to the recording.
+	 */
+	static FRecordedState CaptureState(const ANeuroStrikeCharacter& Character);
+
+	/**
+	 * Finds the recording identifier of a character, and starts recording it if it is not recorded yet. Events
+	 * can come in before the snapshot of the frame picks up a character that just spawned.
+	 *
+	 * @param Actor The character, or any other actor.
+	 * @return The identifier, or zero if the actor is not a character.
+	 */
+	uint32 FindOrAddId(const AActor* Actor);
+
+	/**
+	 * Starts recording a character. Its full state is written with the next snapshot.
+	 *
+	 * @param Character The character, not recorded yet.
+	 * @return The identifier given to the character.
+	 */
+	uint32 AddCharacter(ANeuroStrikeCharacter* Character);
+
+	/** Picks up characters that started playing since the previous snapshot. */
+	void GatherCharacters();
+
+	/**
+	 * Bit-packs the snapshot of the frame and appends it to the pending buffer.
+	 *
+	 * @param Time Server world time of the snapshot.
+	 * @param bKeyframe Whether to write the full state instead of the changes.
+	 */
+	void WriteSnapshot(float Time, bool bKeyframe);
+
+	/** Hands the pending buffer to the writer thread. */
+	void FlushBuffer();
+
+	/** Characters being recorded. */
+	TArray<FRecordedCharacter> RecordedCharacters;
+
+	/** Index into RecordedCharacters of every recorded character. */
+	TMap<TObjectKey<ANeuroStrikeCharacter>, int32> CharacterIndices;
+
+	/** Identifiers of characters that stopped being recorded since the previous snapshot. */
+	TArray<uint32> RemovedIds;
+
+	/** Events of the current frame. */
+	TArray<FRecordedEvent> PendingEvents;
+
+	/** Bit writer the snapshot of the frame is packed into, reset every frame so its storage is reused. */
+	FBitWriter SnapshotBits{1024 * 8, true};
+
+	/** Bytes of the recording not yet handed to the writer thread. */
+	TArray<uint8> Buffer;
+
+	/** Time and file offset of every keyframe written so far. */
+	TArray<TPair<float, uint64>> KeyframeIndex;
+
+	/** Thread writing full buffers to the recording file. */
+	TUniquePtr<FNeuroStrikeRecordingWriter> Writer;
+
+	/** Number of bytes handed to the writer thread so far. */
+	uint64 BytesFlushed = 0;
+
+	/** Identifier given to the next character that starts being recorded. */
+	uint32 NextId = 1;
+
+	/** Server world time of the last keyframe, or a negative value if none has been written yet. */
+	float LastKeyframeTime = -1.0f;
+};
@@ -0,0 +1,224 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeMovementComponent.h"
+#include "NeuroStrikeCharacter.h"
+
+void FNeuroStrikeMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement,
+                                                                   const FClientAdjustment& PendingAdjustment) {
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	const ANeuroStrikeCharacter* Character = Cast<ANeuroStrikeCharacter>(CharacterMovement.GetCharacterOwner());
+	this->Stamina = Character != nullptr
+		                ? FNeuroStrikeMovementState::Quantize(Character->GetStamina(), Character->MaxStamina)
+		                : 0;
+}
+
+bool FNeuroStrikeMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar,
+                                                      UPackageMap* PackageMap) {
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap)) {
+		return false;
+	}
+
+	Ar << this->Stamina;
+	return !Ar.IsError();
+}
+
+UNeuroStrikeMovementComponent::UNeuroStrikeMovementComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer) {
+	this->SetMoveResponseDataContainer(this->StaminaMoveResponseData);
+}
+
+void UNeuroStrikeMovementComponent::SetWantsToSprint(bool bNewWantsToSprint) {
+	this->bWantsToSprint = bNewWantsToSprint;
+}
+
+bool UNeuroStrikeMovementComponent::IsSprinting() const {
+	if (!this->bWantsToSprint) {
+		return false;
+	}
+
+	// Simulated proxies only know the replicated sprint state, not acceleration or stamina.
+	if (this->CharacterOwner != nullptr && this->CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy) {
+		return true;
+	}
+
+	const ANeuroStrikeCharacter* Character = this->GetNeuroStrikeCharacter();
+	return this->IsMovingOnGround()
+		&& !this->Acceleration.IsNearlyZero()
+		&& Character != nullptr
+		&& Character->GetStamina() > 0.0f;
+}
+
+float UNeuroStrikeMovementComponent::GetMaxSpeed() const {
+	if (this->IsSprinting()) {
+		return this->MaxSprintSpeed;
+	}
+
+	return Super::GetMaxSpeed();
+}
+
+void UNeuroStrikeMovementComponent::UpdateFromCompressedFlags(uint8 Flags) {
+	Super::UpdateFromCompressedFlags(Flags);
+
+	this->bWantsToSprint = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+}
+
+FNetworkPredictionData_Client* UNeuroStrikeMovementComponent::GetPredictionData_Client() const {
+	if (this->ClientPredictionData == nullptr) {
+		UNeuroStrikeMovementComponent* MutableThis = const_cast<UNeuroStrikeMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_NeuroStrike(*this);
+	}
+
+	return this->ClientPredictionData;
+}
+
+void UNeuroStrikeMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) {
+	if (!MoveResponse.IsGoodMove()) {
+		++this->NumCorrections;
+	}
+
+	// Saved moves are still pending here; the base class acknowledges or replays them.
+	this->ReconcileStamina(static_cast<const FNeuroStrikeMoveResponseDataContainer&>(MoveResponse));
+
+	Super::ClientHandleMoveResponse(MoveResponse);
+}
+
+void UNeuroStrikeMovementComponent::ReconcileStamina(const FNeuroStrikeMoveResponseDataContainer& MoveResponse) {
+	ANeuroStrikeCharacter* Character = this->GetNeuroStrikeCharacter();
+	FNetworkPredictionData_Client_Character* ClientData = this->GetPredictionData_Client_Character();
+	if (Character == nullptr || ClientData == nullptr) {
+		return;
+	}
+
+	const int32 MoveIndex = ClientData->GetSavedMoveIndex(MoveResponse.ClientAdjustment.TimeStamp);
+	if (MoveIndex == INDEX_NONE) {
+		return;
+	}
+
+	// Both sides are compared at the same byte precision, so quantization alone never counts as an error.
+	const float MaxStamina = Character->MaxStamina;
+	const float PredictedStamina = static_cast<const FSavedMove_NeuroStrike*>(
+		ClientData->SavedMoves[MoveIndex].Get())->SavedStamina;
+	const float Error = FNeuroStrikeMovementState::Dequantize(MoveResponse.Stamina, MaxStamina)
+		- FNeuroStrikeMovementState::Dequantize(FNeuroStrikeMovementState::Quantize(PredictedStamina, MaxStamina),
+		                                        MaxStamina);
+	if (FMath::Abs(Error) <= MaxStamina / 255.0f) {
+		return;
+	}
+
+	// Replayed moves do not spend stamina again, so the error is carried over to everything predicted since.
+	Character->SetStamina(Character->GetStamina() + Error);
+	for (const FSavedMovePtr& SavedMove : ClientData->SavedMoves) {
+		static_cast<FSavedMove_NeuroStrike*>(SavedMove.Get())->SavedStamina += Error;
+	}
+}
+
+void UNeuroStrikeMovementComponent::CallServerMovePacked(const FSavedMove_Character* NewMove,
+                                                         const FSavedMove_Character* PendingMove,
+                                                         const FSavedMove_Character* OldMove) {
+	++this->NumServerMoves;
+
+	Super::CallServerMovePacked(NewMove, PendingMove, OldMove);
+}
+
+void UNeuroStrikeMovementComponent::PhysWalking(float DeltaTime, int32 Iterations) {
+	const bool bSprinting = this->IsSprinting();
+
+	Super::PhysWalking(DeltaTime, Iterations);
+
+	ANeuroStrikeCharacter* Character = this->GetNeuroStrikeCharacter();
+	if (!bSprinting || Character == nullptr || Character->GetLocalRole() == ROLE_SimulatedProxy) {
+		return;
+	}
+
+	// Replayed moves were already paid for when they were first simulated.
+	if (!Character->bClientUpdating) {
+		Character->DecreaseStamina(this->SprintStaminaCostPerSecond * DeltaTime);
+	}
+}
+
+void UNeuroStrikeMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation,
+                                                      const FVector& OldVelocity) {
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+
+	ANeuroStrikeCharacter* Character = this->GetNeuroStrikeCharacter();
+	if (Character == nullptr || Character->GetLocalRole() == ROLE_SimulatedProxy) {
+		return;
+	}
+
+	const bool bSprinting = this->IsSprinting();
+	if (bSprinting != this->bWasSprinting) {
+		this->bWasSprinting = bSprinting;
+		Character->OnSprintStateChanged(bSprinting);
+	}
+}
+
+ANeuroStrikeCharacter* UNeuroStrikeMovementComponent::GetNeuroStrikeCharacter() const {
+	return Cast<ANeuroStrikeCharacter>(this->CharacterOwner);
+}
+
+void FSavedMove_NeuroStrike::Clear() {
+	Super::Clear();
+
+	this->bSavedWantsToSprint = false;
+	this->bSavedIsSprinting = false;
+	this->SavedStamina = 0.0f;
+}
+
+uint8 FSavedMove_NeuroStrike::GetCompressedFlags() const {
+	uint8 Flags = Super::GetCompressedFlags();
+	if (this->bSavedWantsToSprint) {
+		Flags |= FLAG_Custom_0;
+	}
+
+	return Flags;
+}
+
+void FSavedMove_NeuroStrike::SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel,
+                                        FNetworkPredictionData_Client_Character& ClientData) {
+	Super::SetMoveFor(Character, InDeltaTime, NewAccel, ClientData);
+
+	if (const UNeuroStrikeMovementComponent* Movement = Cast<UNeuroStrikeMovementComponent>(
+		Character->GetCharacterMovement())) {
+		this->bSavedWantsToSprint = Movement->bWantsToSprint;
+		this->bSavedIsSprinting = Movement->IsSprinting();
+	}
+}
+
+void FSavedMove_NeuroStrike::PrepMoveFor(ACharacter* Character) {
+	Super::PrepMoveFor(Character);
+
+	if (UNeuroStrikeMovementComponent* Movement = Cast<UNeuroStrikeMovementComponent>(
+		Character->GetCharacterMovement())) {
+		Movement->bWantsToSprint = this->bSavedWantsToSprint;
+	}
+}
+
+void FSavedMove_NeuroStrike::PostUpdate(ACharacter* Character, EPostUpdateMode PostUpdateMode) {
+	Super::PostUpdate(Character, PostUpdateMode);
+
+	if (PostUpdateMode == PostUpdate_Record) {
+		if (const ANeuroStrikeCharacter* NeuroStrikeCharacter = Cast<ANeuroStrikeCharacter>(Character)) {
+			this->SavedStamina = NeuroStrikeCharacter->GetStamina();
+		}
+	}
+}
+
+bool FSavedMove_NeuroStrike::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter,
+                                            float MaxDelta) const {
+	const FSavedMove_NeuroStrike* NewSprintMove = static_cast<const FSavedMove_NeuroStrike*>(NewMove.Get());
+	if (this->bSavedWantsToSprint != NewSprintMove->bSavedWantsToSprint
+		|| this->bSavedIsSprinting != NewSprintMove->bSavedIsSprinting) {
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+FNetworkPredictionData_Client_NeuroStrike::FNetworkPredictionData_Client_NeuroStrike(
+	const UCharacterMovementComponent& ClientMovement) : Super(ClientMovement) {
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_NeuroStrike::AllocateNewMove() {
+	return FSavedMovePtr(new FSavedMove_NeuroStrike());
+}
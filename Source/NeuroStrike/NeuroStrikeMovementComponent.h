@@ -0,0 +1,200 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "NeuroStrikeMovementComponent.generated.h"
+
+class ANeuroStrikeCharacter;
+
+/**
+ * Move response that also carries the server's stamina, quantized to a byte over MaxStamina.
+ */
+struct FNeuroStrikeMoveResponseDataContainer : public FCharacterMoveResponseDataContainer {
+	typedef FCharacterMoveResponseDataContainer Super;
+
+	virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement,
+	                                    const FClientAdjustment& PendingAdjustment) override;
+
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar,
+	                       UPackageMap* PackageMap) override;
+
+	/** Stamina of the character once the server processed the acknowledged or corrected move. */
+	uint8 Stamina = 0;
+};
+
+/**
+ * Character movement component that predicts sprinting.
+ *
+ * Sprint intent travels with every saved move as a compressed flag, so the server simulates exactly the same
+ * speed the owning client predicted instead of correcting it. The sprint speed is applied through GetMaxSpeed,
+ * and stamina is spent inside PhysWalking, on the owning client and on the server alike, so it only drains for
+ * time actually spent sprinting on the ground and never depends on how often input callbacks fire.
+ *
+ * Every move response carries the server's stamina after that move. The owning client compares it with the
+ * stamina it predicted for the same saved move, so the check is independent of latency, and only shifts its
+ * stamina by the error when the two differ by more than the quantization step.
+ */
+UCLASS()
+class NEUROSTRIKE_API UNeuroStrikeMovementComponent : public UCharacterMovementComponent {
+	GENERATED_BODY()
+
+	friend class FSavedMove_NeuroStrike;
+
+public:
+	UNeuroStrikeMovementComponent(const FObjectInitializer& ObjectInitializer);
+
+	/**
+	 * Maximum ground speed while sprinting, in units per second.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement: Sprint", meta=(ClampMin="0"))
+	float MaxSprintSpeed = 750.0f;
+
+	/**
+	 * Stamina spent per second of sprinting.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Character Movement: Sprint", meta=(ClampMin="0"))
+	float SprintStaminaCostPerSecond = 6.0f;
+
+	/**
+	 * Sets whether the character wants to sprint.
+	 *
+	 * Called by input on the owning client; the intent reaches the server through the saved moves.
+	 *
+	 * @param bNewWantsToSprint true to start sprinting, false to stop.
+	 */
+	void SetWantsToSprint(bool bNewWantsToSprint);
+
+	/**
+	 * Checks whether the character is currently moving at sprint speed.
+	 *
+	 * @return true if sprint is requested, the character is walking on the ground with acceleration
+	 *         and has stamina left.
+	 */
+	bool IsSprinting() const;
+
+	virtual float GetMaxSpeed() const override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	/**
+	 * Retrieves how many moves the server has corrected since the component was created. Owning client only.
+	 *
+	 * @return The number of move responses that carried a position correction.
+	 */
+	int32 GetNumCorrections() const {
+		return this->NumCorrections;
+	}
+
+	/**
+	 * Retrieves how many packed move RPCs have been sent since the component was created. Owning client only.
+	 *
+	 * @return The number of ServerMovePacked calls.
+	 */
+	int32 GetNumServerMoves() const {
+		return this->NumServerMoves;
+	}
+
+	/**
+	 * Handles the server's response to a move, counting corrections and reconciling the predicted stamina.
+	 */
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+
+protected:
+	/**
+	 * Walks the character and spends sprint stamina for the simulated time.
+	 *
+	 * @param DeltaTime Simulated time of this walking step.
+	 * @param Iterations Number of movement iterations already run this frame.
+	 */
+	virtual void PhysWalking(float DeltaTime, int32 Iterations) override;
+
+	/**
+	 * Reports sprint state changes to the owning character after every move.
+	 */
+	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
+
+	/**
+	 * Sends moves to the server, counting the RPCs.
+	 */
+	virtual void CallServerMovePacked(const FSavedMove_Character* NewMove, const FSavedMove_Character* PendingMove,
+	                                  const FSavedMove_Character* OldMove) override;
+
+private:
+	/**
+	 * Retrieves the owning character as a NeuroStrike character.
+	 *
+	 * @return The owning character, or nullptr if the component is used on another character class.
+	 */
+	ANeuroStrikeCharacter* GetNeuroStrikeCharacter() const;
+
+	/**
+	 * Shifts the predicted stamina by the error between the server's stamina after a move and the stamina
+	 * predicted for that move, if larger than the quantization step. Owning client only.
+	 *
+	 * @param MoveResponse The server's response to a saved move.
+	 */
+	void ReconcileStamina(const FNeuroStrikeMoveResponseDataContainer& MoveResponse);
+
+	/** Move response sent by the server and received by the owning client in place of the default one. */
+	FNeuroStrikeMoveResponseDataContainer StaminaMoveResponseData;
+
+	/** Sprint intent of the current move. */
+	bool bWantsToSprint = false;
+
+	/** Sprint state observed after the previous move, used to detect changes. */
+	bool bWasSprinting = false;
+
+	/** Move responses received with a correction. */
+	int32 NumCorrections = 0;
+
+	/** Packed move RPCs sent to the server. */
+	int32 NumServerMoves = 0;
+};
+
+/**
+ * Saved move that records the sprint intent of a client move.
+ */
+class FSavedMove_NeuroStrike : public FSavedMove_Character {
+public:
+	typedef FSavedMove_Character Super;
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual void SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel,
+	                        FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* Character) override;
+
+	/**
+	 * Records the stamina predicted at the end of the move, compared with the server's on its response.
+	 */
+	virtual void PostUpdate(ACharacter* Character, EPostUpdateMode PostUpdateMode) override;
+
+	/**
+	 * Prevents combining moves across a change of effective sprint state, such as running out of stamina,
+	 * which would otherwise replay at the wrong speed on the server.
+	 */
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+
+	/** Sprint intent at the time the move was made. */
+	bool bSavedWantsToSprint = false;
+
+	/** Whether the character was actually moving at sprint speed when the move was made. */
+	bool bSavedIsSprinting = false;
+
+	/** Stamina predicted at the end of the move. */
+	float SavedStamina = 0.0f;
+};
+
+/**
+ * Client prediction data that allocates NeuroStrike saved moves.
+ */
+class FNetworkPredictionData_Client_NeuroStrike : public FNetworkPredictionData_Client_Character {
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	explicit FNetworkPredictionData_Client_NeuroStrike(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikePickupSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "TP_PickUpComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+void UNeuroStrikePickupSubsystem::Deinitialize() {
+	this->Cells.Empty();
+	this->PickupCells.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNeuroStrikePickupSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UNeuroStrikePickupSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNeuroStrikePickupSubsystem, STATGROUP_NeuroStrike);
+}
+
+void UNeuroStrikePickupSubsystem::RegisterPickup(UTP_PickUpComponent* Pickup) {
+	if (Pickup == nullptr) {
+		return;
+	}
+
+	this->UnregisterPickup(Pickup);
+
+	const FIntPoint Cell = this->GetCell(Pickup->GetComponentLocation());
+	this->Cells.FindOrAdd(Cell).Add(Pickup);
+	this->PickupCells.Add(Pickup, Cell);
+	this->MaxPickupRadius = FMath::Max(this->MaxPickupRadius, Pickup->GetScaledSphereRadius());
+}
+
+void UNeuroStrikePickupSubsystem::UnregisterPickup(UTP_PickUpComponent* Pickup) {
+	FIntPoint Cell;
+	if (!this->PickupCells.RemoveAndCopyValue(Pickup, Cell)) {
+		return;
+	}
+
+	if (TArray<TWeakObjectPtr<UTP_PickUpComponent>>* CellPickups = this->Cells.Find(Cell)) {
+		CellPickups->RemoveSingleSwap(Pickup, false);
+		if (CellPickups->Num() == 0) {
+			this->Cells.Remove(Cell);
+		}
+	}
+}
+
+void UNeuroStrikePickupSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	this->TimeSinceUpdate += DeltaTime;
+	if (this->PickupCells.Num() == 0 || this->TimeSinceUpdate < 1.0f / FMath::Max(this->UpdateRate, 1.0f)) {
+		return;
+	}
+	this->TimeSinceUpdate = 0.0f;
+
+	// Broadcasting may register, unregister or destroy pickups, so contacts are collected first.
+	TArray<TPair<TWeakObjectPtr<UTP_PickUpComponent>, TWeakObjectPtr<ANeuroStrikeCharacter>>, TInlineAllocator<4>>
+		Contacts;
+
+	for (TActorIterator<ANeuroStrikeCharacter> It(this->GetWorld()); It; ++It) {
+		ANeuroStrikeCharacter* Character = *It;
+		if (Character->IsDead()) {
+			continue;
+		}
+
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+		const float CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+		const FVector Center = Capsule->GetComponentLocation();
+		const FVector HalfSegment = Capsule->GetUpVector() * Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere();
+
+		const int32 CellSpan = FMath::CeilToInt((CapsuleRadius + this->MaxPickupRadius) / this->CellSize);
+		const FIntPoint CharacterCell = this->GetCell(Center);
+
+		for (int32 X = CharacterCell.X - CellSpan; X <= CharacterCell.X + CellSpan; ++X) {
+			for (int32 Y = CharacterCell.Y - CellSpan; Y <= CharacterCell.Y + CellSpan; ++Y) {
+				const TArray<TWeakObjectPtr<UTP_PickUpComponent>>* CellPickups = this->Cells.Find(FIntPoint(X, Y));
+				if (CellPickups == nullptr) {
+					continue;
+				}
+
+				for (const TWeakObjectPtr<UTP_PickUpComponent>& WeakPickup : *CellPickups) {
+					const UTP_PickUpComponent* Pickup = WeakPickup.Get();
+					if (Pickup == nullptr) {
+						continue;
+					}
+
+					const float ContactDistance = CapsuleRadius + Pickup->GetScaledSphereRadius();
+					const float DistanceSquared = FMath::PointDistToSegmentSquared(
+						Pickup->GetComponentLocation(), Center - HalfSegment, Center + HalfSegment);
+					if (DistanceSquared <= FMath::Square(ContactDistance)) {
+						Contacts.Emplace(WeakPickup, Character);
+					}
+				}
+			}
+		}
+	}
+
+	for (const auto& Contact : Contacts) {
+		UTP_PickUpComponent* Pickup = Contact.Key.Get();
+		ANeuroStrikeCharacter* Character = Contact.Value.Get();
+		if (Pickup != nullptr && Character != nullptr && this->PickupCells.Contains(Pickup)) {
+			Pickup->NotifyPickedUp(Character);
+		}
+	}
+}
+
+FIntPoint UNeuroStrikePickupSubsystem::GetCell(const FVector& Location) const {
+	return FIntPoint(FMath::FloorToInt(Location.X / this->CellSize), FMath::FloorToInt(Location.Y / this->CellSize));
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikePickupSubsystem.generated.h"
+
+class UTP_PickUpComponent;
+
+/**
+ * World subsystem that detects characters reaching pickups without physics overlaps.
+ *
+ * Pickups register their location once and are stored in a 2D spatial hash of CellSize cells. At UpdateRate
+ * times per second every character's capsule is tested only against the pickups in the cells around it, and
+ * the pickup's OnPickUp delegate is broadcast on contact. Character movement therefore no longer pays for
+ * overlap updates against every pickup sphere on the map.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikePickupSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Tests characters against nearby pickups once the update interval has elapsed.
+	 *
+	 * @param DeltaTime Time elapsed since the previous frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Adds a pickup to the spatial hash at its current location. Registering again moves it.
+	 *
+	 * @param Pickup The pickup to index.
+	 */
+	void RegisterPickup(UTP_PickUpComponent* Pickup);
+
+	/**
+	 * Removes a pickup from the spatial hash.
+	 *
+	 * @param Pickup The pickup to remove.
+	 */
+	void UnregisterPickup(UTP_PickUpComponent* Pickup);
+
+	/** Edge length in world units of a spatial hash cell. */
+	UPROPERTY(config)
+	float CellSize = 500.0f;
+
+	/** Number of times per second characters are tested against pickups. */
+	UPROPERTY(config)
+	float UpdateRate = 15.0f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * Computes the spatial hash cell containing a location.
+	 *
+	 * @param Location The world location.
+	 * @return The cell coordinates.
+	 */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Pickups per occupied cell. */
+	TMap<FIntPoint, TArray<TWeakObjectPtr<UTP_PickUpComponent>>> Cells;
+
+	/** Cell each registered pickup is stored in. */
+	TMap<TWeakObjectPtr<UTP_PickUpComponent>, FIntPoint> PickupCells;
+
+	/** Largest radius of any registered pickup, which bounds how many cells a query has to visit. */
+	float MaxPickupRadius = 0.0f;
+
+	/** Time accumulated since the last test. */
+	float TimeSinceUpdate = 0.0f;
+};
@@ -1,8 +1,12 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
-
 #include "NeuroStrikePlayerController.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
 #include "EnhancedInputSubsystems.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
 
 void ANeuroStrikePlayerController::BeginPlay() {
 	Super::BeginPlay();
@@ -12,3 +16,53 @@ void ANeuroStrikePlayerController::BeginPlay() {
 		Subsystem->AddMappingContext(InputMappingContext, 0);
 	}
 }
+
+void ANeuroStrikePlayerController::AddMoveInput(const FVector2D& Value) {
+	this->PendingFrameInput.Move = Value;
+	++this->PendingFrameInput.NumMoveSamples;
+}
+
+void ANeuroStrikePlayerController::AddLookInput(const FVector2D& Delta) {
+	this->PendingFrameInput.Look += Delta;
+	++this->PendingFrameInput.NumLookSamples;
+}
+
+void ANeuroStrikePlayerController::PostProcessInput(const float DeltaTime, const bool bGamePaused) {
+	Super::PostProcessInput(DeltaTime, bGamePaused);
+
+	if (this->PendingFrameInput.HasInput()) {
+		if (ANeuroStrikeCharacter* Character = Cast<ANeuroStrikeCharacter>(this->GetPawn())) {
+			Character->ApplyFrameInput(this->PendingFrameInput);
+		}
+	}
+
+	this->PendingFrameInput = FNeuroStrikeFrameInput();
+}
+
+bool ANeuroStrikePlayerController::ConsumeServerRpcBudget(FName RpcName) {
+	const double Now = GetWorld()->GetRealTimeSeconds();
+	const float* RateOverride = this->ServerRpcRateOverrides.Find(RpcName);
+	const float Rate = RateOverride != nullptr ? *RateOverride : this->ServerRpcRate;
+	const float Capacity = Rate + this->ServerRpcBurst;
+
+	FRpcBudget* Budget = this->RpcBudgets.Find(RpcName);
+	if (Budget == nullptr) {
+		Budget = &this->RpcBudgets.Add(RpcName, {Capacity, Now});
+	}
+
+	Budget->Tokens = FMath::Min(Budget->Tokens + static_cast<float>(Now - Budget->LastRefillTime) * Rate, Capacity);
+	Budget->LastRefillTime = Now;
+
+	if (Budget->Tokens >= 1.0f) {
+		Budget->Tokens -= 1.0f;
+		return true;
+	}
+
+	INC_DWORD_STAT(STAT_NeuroStrike_RPC_Throttled);
+	if (this->LastThrottleLogTime < 0.0 || Now - this->LastThrottleLogTime >= 1.0) {
+		this->LastThrottleLogTime = Now;
+		UE_LOG(LogNeuroStrike, Warning, TEXT("Dropping %s from %s: more than %.0f calls per second"),
+		       *RpcName.ToString(), *GetNameSafe(this->PlayerState), Rate);
+	}
+	return false;
+}
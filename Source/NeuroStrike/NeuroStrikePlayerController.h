@@ -9,12 +9,101 @@
 class UInputMappingContext;
 
 /**
- * Player controller class for handling input-related operations specific to NeuroStrike.
+ * Look and move input gathered over one frame of input processing.
  */
-UCLASS()
+struct FNeuroStrikeFrameInput {
+	/** Movement axis value of the frame: X for right/left, Y for forward/backward. */
+	FVector2D Move = FVector2D::ZeroVector;
+
+	/** Look axis delta of the frame: X for yaw, Y for pitch. */
+	FVector2D Look = FVector2D::ZeroVector;
+
+	/** Movement callbacks gathered, zero if the movement action did not trigger. */
+	int32 NumMoveSamples = 0;
+
+	/** Look callbacks gathered, zero if the look action did not trigger. */
+	int32 NumLookSamples = 0;
+
+	/**
+	 * Checks whether any sample was gathered.
+	 *
+	 * @return true if the movement or the look action triggered during the frame.
+	 */
+	bool HasInput() const {
+		return this->NumMoveSamples > 0 || this->NumLookSamples > 0;
+	}
+};
+
+/**
+ * Player controller of NeuroStrike players.
+ *
+ * On the server it owns the per-connection rate limits of client RPCs: each limited RPC draws from a token
+ * bucket refilled at ServerRpcRate tokens per second, so a buggy or abusive client cannot make the server
+ * process more than a bounded number of its calls, however fast it sends them.
+ *
+ * On the owning client it gathers look and move input: the character's input handlers only record values into a
+ * per-frame input state, which is applied to the pawn once after input processing, before the control rotation is
+ * updated. Enhanced Input already aggregates the raw device events of a frame, so each action triggers at most
+ * once per frame; the gathering only defers the pawn update, it does not see individual device samples.
+ */
+UCLASS(config=Game)
 class NEUROSTRIKE_API ANeuroStrikePlayerController : public APlayerController {
 	GENERATED_BODY()
 
+public:
+	/**
+	 * Gathers a movement axis value into this frame's input. The latest value of the frame wins.
+	 *
+	 * @param Value Movement axis value: X for right/left, Y for forward/backward.
+	 */
+	void AddMoveInput(const FVector2D& Value);
+
+	/**
+	 * Gathers a look axis delta into this frame's input. Deltas of the frame add up.
+	 *
+	 * @param Delta Look axis delta: X for yaw, Y for pitch.
+	 */
+	void AddLookInput(const FVector2D& Delta);
+
+	/**
+	 * Applies the input gathered during input processing to the pawn, before the control rotation is updated.
+	 */
+	virtual void PostProcessInput(const float DeltaTime, const bool bGamePaused) override;
+
+	/**
+	 * Consumes a call of a rate-limited server RPC. Authority only.
+	 *
+	 * @param RpcName Name of the RPC, each one having its own budget.
+	 * @return true if the call should be processed, false if it exceeds the connection's budget and must be dropped.
+	 */
+	bool ConsumeServerRpcBudget(FName RpcName);
+
+	/** Counts a server RPC sent by this client. Movement RPCs are counted by the movement component instead. */
+	void NotifyServerRpcSent() {
+		++this->ServerRpcsSent;
+	}
+
+	/**
+	 * Retrieves how many server RPCs this client has sent, excluding movement.
+	 *
+	 * @return The number of RPCs counted by NotifyServerRpcSent.
+	 */
+	int32 GetServerRpcsSent() const {
+		return this->ServerRpcsSent;
+	}
+
+	/** Calls per second each limited server RPC may sustain. */
+	UPROPERTY(config)
+	float ServerRpcRate = 30.0f;
+
+	/** Calls each limited server RPC may burst above its sustained rate. */
+	UPROPERTY(config)
+	float ServerRpcBurst = 10.0f;
+
+	/** Sustained rates overriding ServerRpcRate for specific RPCs, by RPC name. */
+	UPROPERTY(config)
+	TMap<FName, float> ServerRpcRateOverrides;
+
 protected:
 	/**
 	 * Reference to an input mapping context used to define and manage input configurations for the player controller.
@@ -29,7 +118,25 @@ protected:
 	 * This method performs the following actions:
 	 * - Calls the base implementation of BeginPlay from the parent class.
 	 * - Retrieves the enhanced input subsystem for the local player and adds the defined input mapping context.
-	 * - Logs a debug message indicating the execution of BeginPlay.
 	 */
 	virtual void BeginPlay() override;
+
+private:
+	/** Input gathered so far during the current frame. */
+	FNeuroStrikeFrameInput PendingFrameInput;
+
+	/** Token bucket of a single rate-limited RPC. */
+	struct FRpcBudget {
+		float Tokens = 0.0f;
+		double LastRefillTime = 0.0;
+	};
+
+	/** Budget of every rate-limited RPC this connection has called. */
+	TMap<FName, FRpcBudget> RpcBudgets;
+
+	/** Real time at which dropped calls were last logged, to avoid flooding the log in turn. */
+	double LastThrottleLogTime = -1.0;
+
+	/** Server RPCs sent by this client, on the owning client. */
+	int32 ServerRpcsSent = 0;
 };
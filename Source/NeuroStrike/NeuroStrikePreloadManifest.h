@@ -0,0 +1,27 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "NeuroStrikePreloadManifest.generated.h"
+
+/**
+ * List of assets streamed in while a map loads, so they are resident before the first shot or death needs them.
+ *
+ * Gameplay assets are loaded everywhere. Cosmetic assets, such as sounds, montages and meshes that only matter
+ * for presentation, are skipped on dedicated servers.
+ */
+UCLASS(BlueprintType)
+class NEUROSTRIKE_API UNeuroStrikePreloadManifest : public UPrimaryDataAsset {
+	GENERATED_BODY()
+
+public:
+	/** Classes and assets needed to run the match, loaded on every machine. */
+	UPROPERTY(EditDefaultsOnly, Category=Preload)
+	TArray<TSoftClassPtr<UObject>> GameplayClasses;
+
+	/** Presentation-only assets, never loaded on dedicated servers. */
+	UPROPERTY(EditDefaultsOnly, Category=Preload)
+	TArray<TSoftObjectPtr<UObject>> CosmeticAssets;
+};
@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikePreloadSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikePreloadManifest.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+
+void UNeuroStrikePreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	const UWorld* World = this->GetWorld();
+	const FString MapName = UWorld::RemovePIEPrefix(World->GetMapName());
+	if (const TSoftObjectPtr<UNeuroStrikePreloadManifest>* Entry = this->MapManifests.Find(MapName)) {
+		this->Manifest = *Entry;
+		this->RequestAsyncLoad({this->Manifest.ToSoftObjectPath()}, false,
+		                       FStreamableDelegate::CreateUObject(
+			                       this, &UNeuroStrikePreloadSubsystem::OnManifestLoaded));
+	}
+}
+
+void UNeuroStrikePreloadSubsystem::Deinitialize() {
+	for (const TSharedPtr<FStreamableHandle>& Handle : this->Handles) {
+		if (Handle.IsValid()) {
+			Handle->ReleaseHandle();
+		}
+	}
+	this->Handles.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNeuroStrikePreloadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TSharedPtr<FStreamableHandle> UNeuroStrikePreloadSubsystem::RequestAsyncLoad(const TArray<FSoftObjectPath>& Assets,
+                                                                             bool bCosmetic,
+                                                                             FStreamableDelegate OnLoaded) {
+	if (Assets.Num() == 0 || (bCosmetic && !ShouldLoadCosmetics(this->GetWorld()))) {
+		return nullptr;
+	}
+
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		Assets, MoveTemp(OnLoaded), FStreamableManager::AsyncLoadHighPriority);
+	if (Handle.IsValid()) {
+		this->Handles.Add(Handle);
+	}
+
+	return Handle;
+}
+
+bool UNeuroStrikePreloadSubsystem::ShouldLoadCosmetics(const UWorld* World) {
+	return !IsRunningDedicatedServer() && (World == nullptr || World->GetNetMode() != NM_DedicatedServer);
+}
+
+void UNeuroStrikePreloadSubsystem::OnManifestLoaded() {
+	const UNeuroStrikePreloadManifest* LoadedManifest = this->Manifest.Get();
+	if (LoadedManifest == nullptr) {
+		UE_LOG(LogNeuroStrike, Warning, TEXT("Preload manifest %s could not be loaded"),
+		       *this->Manifest.ToString());
+		return;
+	}
+
+	TArray<FSoftObjectPath> GameplayAssets;
+	for (const TSoftClassPtr<UObject>& Class : LoadedManifest->GameplayClasses) {
+		GameplayAssets.Add(Class.ToSoftObjectPath());
+	}
+
+	TArray<FSoftObjectPath> CosmeticAssets;
+	for (const TSoftObjectPtr<UObject>& Asset : LoadedManifest->CosmeticAssets) {
+		CosmeticAssets.Add(Asset.ToSoftObjectPath());
+	}
+
+	this->RequestAsyncLoad(GameplayAssets, false);
+	this->RequestAsyncLoad(CosmeticAssets, true);
+}
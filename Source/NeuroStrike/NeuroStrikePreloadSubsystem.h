@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikePreloadSubsystem.generated.h"
+
+class UNeuroStrikePreloadManifest;
+
+/**
+ * World subsystem that streams the preload manifest of the current map and owns asynchronous asset loads.
+ *
+ * Every soft reference of the game (weapon sounds and montages, tomb meshes, the player pawn class) is loaded
+ * through here via the asset manager's FStreamableManager rather than synchronously with the objects that
+ * reference them. Loads flagged as cosmetic are skipped entirely on dedicated servers, which then never keep
+ * presentation assets in memory.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikePreloadSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Starts streaming the manifest configured for the map being loaded.
+	 */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/**
+	 * Releases every handle, letting the streamed assets be collected with the world.
+	 */
+	virtual void Deinitialize() override;
+
+	/**
+	 * Streams a set of assets in the background.
+	 *
+	 * The returned handle keeps the assets loaded; the subsystem also keeps it until the world is torn down
+	 * unless the caller releases it. When the assets are already resident, the delegate runs immediately.
+	 *
+	 * @param Assets The assets to load.
+	 * @param bCosmetic Whether the assets only matter for presentation. Cosmetic loads do nothing on
+	 *                  dedicated servers and the delegate is not called.
+	 * @param OnLoaded Called on the game thread once every asset is loaded.
+	 * @return The streaming handle, or nullptr if nothing was requested.
+	 */
+	TSharedPtr<FStreamableHandle> RequestAsyncLoad(const TArray<FSoftObjectPath>& Assets, bool bCosmetic,
+	                                               FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	/**
+	 * Checks whether presentation assets should be loaded in the given world.
+	 *
+	 * @param World The world to check.
+	 * @return false on dedicated servers.
+	 */
+	static bool ShouldLoadCosmetics(const UWorld* World);
+
+	/** Preload manifest per map, keyed by the short map name without PIE prefix. */
+	UPROPERTY(config)
+	TMap<FString, TSoftObjectPtr<UNeuroStrikePreloadManifest>> MapManifests;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * Requests every asset of the loaded manifest.
+	 */
+	void OnManifestLoaded();
+
+	/** Manifest of the current map, once loaded. */
+	TSoftObjectPtr<UNeuroStrikePreloadManifest> Manifest;
+
+	/** Handles kept alive for the lifetime of the world. */
+	TArray<TSharedPtr<FStreamableHandle>> Handles;
+};
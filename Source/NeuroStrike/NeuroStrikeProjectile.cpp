@@ -1,15 +1,33 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "NeuroStrikeProjectile.h"
-
+#include "NeuroStrike.h"
 #include "NeuroStrikeCharacter.h"
+#include "NeuroStrikeDamageSubsystem.h"
+#include "NeuroStrikeLatencySubsystem.h"
+#include "NeuroStrikeMatchRecorderSubsystem.h"
+#include "NeuroStrikeProjectilePoolSubsystem.h"
+#include "NeuroStrikeWeaponDefinition.h"
+#include "TP_WeaponComponent.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+
+const FName ANeuroStrikeProjectile::ImpulseActorTag(TEXT("ProjectileImpulse"));
 
 ANeuroStrikeProjectile::ANeuroStrikeProjectile() {
 	this->CollisionComp = this->CreateDefaultSubobject<USphereComponent>("SphereComp");
 	this->CollisionComp->InitSphereRadius(5.0f);
-	this->CollisionComp->BodyInstance.SetCollisionProfileName("Projectile");
+	this->CollisionComp->SetCollisionObjectType(ECC_NeuroStrikeProjectile);
+	this->CollisionComp->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	this->CollisionComp->SetCollisionResponseToAllChannels(ECR_Ignore);
+	this->CollisionComp->SetCollisionResponseToChannel(ECC_WorldStatic, ECR_Block);
+	this->CollisionComp->SetCollisionResponseToChannel(ECC_WorldDynamic, ECR_Block);
+	this->CollisionComp->SetCollisionResponseToChannel(ECC_Pawn, ECR_Block);
+	this->CollisionComp->SetCollisionResponseToChannel(ECC_PhysicsBody, ECR_Block);
+	this->CollisionComp->SetGenerateOverlapEvents(false);
+	this->CollisionComp->BodyInstance.bUseCCD = false;
 	this->CollisionComp->OnComponentHit.AddDynamic(this, &ANeuroStrikeProjectile::OnHit);
 	this->CollisionComp->SetWalkableSlopeOverride(FWalkableSlopeOverride(WalkableSlope_Unwalkable, 0.f));
 	this->CollisionComp->CanCharacterStepUpOn = ECB_No;
@@ -21,24 +39,212 @@ ANeuroStrikeProjectile::ANeuroStrikeProjectile() {
 	this->ProjectileMovement->InitialSpeed = 3000.f;
 	this->ProjectileMovement->MaxSpeed = 3000.f;
 	this->ProjectileMovement->bRotationFollowsVelocity = true;
-	this->ProjectileMovement->bShouldBounce = true;
+	this->ProjectileMovement->bShouldBounce = false;
 
-	this->InitialLifeSpan = 3.0f;
+	// Expiry is driven by LifeSpan so pooled projectiles are released rather than destroyed by the engine.
+	this->InitialLifeSpan = 0.0f;
 }
 
 void ANeuroStrikeProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp,
                                    FVector NormalImpulse, const FHitResult& Hit) {
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Projectile OnHit", STAT_NeuroStrike_ProjectileOnHit);
+
+	const bool bCosmetic = this->IsCosmetic();
+
+	if (!bCosmetic && OtherActor != nullptr && OtherActor != this && OtherComp != nullptr
+		&& OtherComp->IsSimulatingPhysics() && OtherActor->ActorHasTag(ImpulseActorTag)) {
+		OtherComp->AddImpulseAtLocation(GetVelocity() * this->ImpulseScale, GetActorLocation());
+	}
+
+	// Bouncing projectiles keep flying after hitting geometry, until they hit a character or expire.
+	if (this->LaunchState.bBounces && Cast<ANeuroStrikeCharacter>(OtherActor) == nullptr) {
+		return;
+	}
+
 	if (OtherActor && (OtherActor != this) && OtherComp) {
+		if (this->HasAuthority() && !bCosmetic) {
+			if (UNeuroStrikeMatchRecorderSubsystem* Recorder = UNeuroStrikeMatchRecorderSubsystem::GetActive(
+				GetWorld())) {
+				Recorder->RecordProjectileHit(this->GetInstigator(), Hit.ImpactPoint, this->LaunchState.ShotId);
+			}
+			if (UNeuroStrikeLatencySubsystem* Latency = GetWorld()->GetSubsystem<UNeuroStrikeLatencySubsystem>()) {
+				Latency->RecordSpan(this->GetInstigator(), ENeuroStrikeLatencySpan::ShotToHit,
+				                    GetWorld()->GetTimeSeconds() - this->LaunchTime);
+			}
+		}
+
 		ANeuroStrikeCharacter* HitCharacter = Cast<ANeuroStrikeCharacter>(OtherActor);
+		if (HitCharacter && bCosmetic) {
+			this->NotifyPredictedHit(HitCharacter);
+		}
 		if (HitCharacter) {
-			if (this->HasAuthority()) {
-				HitCharacter->DecreaseHealth(FMath::RandRange(10, 20));
+			if (this->HasAuthority() && !bCosmetic) {
+				if (UNeuroStrikeDamageSubsystem* Damage = GetWorld()->GetSubsystem<UNeuroStrikeDamageSubsystem>()) {
+					// Projectiles launched without stats deal the damage of a default weapon.
+					const FNeuroStrikeWeaponStats& Stats = this->WeaponStats.IsValid()
+						                                       ? *this->WeaponStats
+						                                       : FNeuroStrikeWeaponStats::GetDefault();
+					const float Distance = FVector::Dist(this->LaunchState.Location, Hit.ImpactPoint);
+					const float Amount = Stats.RollDamage(FMath::FRand()) * Stats.GetFalloff(Distance);
+					Damage->QueueDamage(Cast<ANeuroStrikeCharacter>(this->GetInstigator()), HitCharacter, Amount,
+					                    Hit.ImpactPoint);
+				}
 			}
 		}
+		this->Release();
+	}
+}
+
+void ANeuroStrikeProjectile::NotifyPredictedHit(const ANeuroStrikeCharacter* Victim) const {
+	const ANeuroStrikeCharacter* Shooter = Cast<ANeuroStrikeCharacter>(this->GetInstigator());
+	UNeuroStrikeLatencySubsystem* Latency = GetWorld()->GetSubsystem<UNeuroStrikeLatencySubsystem>();
+	if (Shooter == nullptr || !Shooter->IsLocallyControlled() || Latency == nullptr
+		|| !Latency->IsFireToHealthEnabled()) {
+		return;
+	}
+
+	// The shot left the muzzle as long ago as the projectile has been flying, in the server's clock.
+	const float ShotTime = Shooter->GetClientShotTime() - (GetWorld()->GetTimeSeconds() - this->LaunchTime);
+	Latency->NotifyLocalShot(Shooter, ShotTime, Victim);
+}
+
+void ANeuroStrikeProjectile::PostInitializeComponents() {
+	Super::PostInitializeComponents();
+
+	for (const TEnumAsByte<ECollisionChannel> Channel : this->AdditionalBlockingChannels) {
+		this->CollisionComp->SetCollisionResponseToChannel(Channel, ECR_Block);
+	}
+}
+
+void ANeuroStrikeProjectile::SetOwningPool(UNeuroStrikeProjectilePoolSubsystem* Pool) {
+	this->OwningPool = Pool;
+}
+
+bool ANeuroStrikeProjectile::CanLaunchFrom(const FVector& Location) const {
+	const UWorld* World = this->GetWorld();
+	if (World == nullptr) {
+		return false;
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileLaunchTest), false, this);
+	const FCollisionResponseParams ResponseParams(this->CollisionComp->GetCollisionResponseToChannels());
+	return !World->OverlapBlockingTestByChannel(Location, FQuat::Identity,
+	                                            this->CollisionComp->GetCollisionObjectType(),
+	                                            this->CollisionComp->GetCollisionShape(), QueryParams, ResponseParams);
+}
+
+void ANeuroStrikeProjectile::Launch(const FVector& Location, const FRotator& Rotation, uint16 ShotId,
+                                    const TSharedPtr<const FNeuroStrikeWeaponStats>& Stats) {
+	this->WeaponStats = Stats;
+	this->LaunchTime = GetWorld()->GetTimeSeconds();
+
+	const float StatsSpeed = Stats.IsValid() ? Stats->ProjectileSpeed : 0.0f;
+	this->LaunchState.Location = Location;
+	this->LaunchState.Direction = Rotation.Vector();
+	this->LaunchState.Speed = StatsSpeed > 0.0f ? StatsSpeed : this->ProjectileMovement->InitialSpeed;
+	this->LaunchState.ShotId = ShotId;
+	this->LaunchState.bBounces = Stats.IsValid() && Stats->bProjectileBounces;
+	this->LaunchState.Generation++;
+	this->LaunchState.bActive = true;
+
+	this->ApplyLaunchState();
+	this->ForceNetUpdate();
+
+	if (!this->IsCosmetic()) {
+		if (UNeuroStrikeMatchRecorderSubsystem* Recorder = UNeuroStrikeMatchRecorderSubsystem::GetActive(GetWorld())) {
+			Recorder->RecordProjectileLaunch(this->GetInstigator(), Location, this->LaunchState.Direction, ShotId);
+		}
+	}
+}
+
+void ANeuroStrikeProjectile::Deactivate() {
+	this->LaunchState.bActive = false;
+	this->WeaponStats.Reset();
+
+	this->ApplyLaunchState();
+	this->ForceNetUpdate();
+}
+
+void ANeuroStrikeProjectile::Release() {
+	if (!this->HasAuthority()) {
+		// Hide the local copy right away, the authoritative release follows through replication.
+		this->LaunchState.bActive = false;
+		this->ApplyLaunchState();
+		return;
+	}
+
+	if (UNeuroStrikeProjectilePoolSubsystem* Pool = this->OwningPool.Get()) {
+		Pool->Release(this);
+	} else {
 		this->Destroy();
 	}
+}
 
-	if ((OtherActor != nullptr) && (OtherActor != this) && (OtherComp != nullptr) && OtherComp->IsSimulatingPhysics()) {
-		OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
+bool ANeuroStrikeProjectile::IsCosmetic() const {
+	// Actors spawned by a client are authoritative only on that client and never replicate.
+	return this->HasAuthority() && this->GetNetMode() == NM_Client;
+}
+
+void ANeuroStrikeProjectile::OnRep_LaunchState() {
+	this->ApplyLaunchState();
+
+	if (this->LaunchState.bActive && this->WasPredictedLocally()) {
+		this->ProjectileMovement->SetComponentTickEnabled(false);
+		this->SetActorEnableCollision(false);
+		this->SetActorHiddenInGame(true);
 	}
 }
+
+bool ANeuroStrikeProjectile::WasPredictedLocally() const {
+	const ANeuroStrikeCharacter* Shooter = Cast<ANeuroStrikeCharacter>(this->GetInstigator());
+	if (Shooter == nullptr || !Shooter->IsLocallyControlled() || Shooter->WeaponComponent == nullptr) {
+		return false;
+	}
+
+	return Shooter->WeaponComponent->ConsumePredictedShot(this->LaunchState.ShotId);
+}
+
+void ANeuroStrikeProjectile::ApplyLaunchState() {
+	FTimerManager& TimerManager = this->GetWorldTimerManager();
+
+	if (this->LaunchState.bActive) {
+		const FVector Direction = this->LaunchState.Direction;
+		this->SetActorLocationAndRotation(this->LaunchState.Location, Direction.Rotation(), false, nullptr,
+		                                  ETeleportType::ResetPhysics);
+		this->SetActorHiddenInGame(false);
+		this->SetActorEnableCollision(true);
+
+		this->ProjectileMovement->SetUpdatedComponent(this->CollisionComp);
+		// MaxSpeed only caps the velocity, so raising it for faster weapons sharing this class is harmless.
+		this->ProjectileMovement->MaxSpeed = FMath::Max(this->ProjectileMovement->MaxSpeed, this->LaunchState.Speed);
+		this->ProjectileMovement->Velocity = Direction * this->LaunchState.Speed;
+		this->ProjectileMovement->bShouldBounce = this->LaunchState.bBounces;
+		// Sub-steps only apply to bouncing or falling projectiles; split their sweeps by distance, not by time.
+		this->ProjectileMovement->MaxSimulationIterations = this->MaxSubSteps;
+		if (this->LaunchState.Speed > 0.0f) {
+			this->ProjectileMovement->MaxSimulationTimeStep = this->MaxSubStepDistance / this->LaunchState.Speed;
+		}
+		this->ProjectileMovement->UpdateComponentVelocity();
+		this->ProjectileMovement->SetComponentTickEnabled(true);
+
+		const float StatsLifeSpan = this->WeaponStats.IsValid() ? this->WeaponStats->ProjectileLifetime : 0.0f;
+		const float EffectiveLifeSpan = StatsLifeSpan > 0.0f ? StatsLifeSpan : this->LifeSpan;
+		if (this->HasAuthority() && EffectiveLifeSpan > 0.0f) {
+			TimerManager.SetTimer(this->LifeSpanTimerHandle, this, &ANeuroStrikeProjectile::Release,
+			                      EffectiveLifeSpan);
+		}
+	} else {
+		this->ProjectileMovement->StopMovementImmediately();
+		this->ProjectileMovement->SetComponentTickEnabled(false);
+		this->SetActorEnableCollision(false);
+		this->SetActorHiddenInGame(true);
+
+		TimerManager.ClearTimer(this->LifeSpanTimerHandle);
+	}
+}
+
+void ANeuroStrikeProjectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ANeuroStrikeProjectile, LaunchState);
+}
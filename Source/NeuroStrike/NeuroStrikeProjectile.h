@@ -8,11 +8,59 @@
 
 class USphereComponent;
 class UProjectileMovementComponent;
+class UNeuroStrikeProjectilePoolSubsystem;
+class ANeuroStrikeCharacter;
+struct FNeuroStrikeWeaponStats;
+
+/**
+ * Replicated activation state of a pooled projectile.
+ *
+ * Pooled projectiles are never destroyed, so clients cannot rely on actor spawning to learn about a new shot.
+ * The generation counter changes on every launch, which guarantees a replication update even when a projectile
+ * is relaunched from the same spot it was parked at.
+ */
+USTRUCT()
+struct FNeuroStrikeProjectileLaunchState {
+	GENERATED_BODY()
+
+	/** World location the projectile was launched from. */
+	UPROPERTY()
+	FVector_NetQuantize Location = FVector::ZeroVector;
+
+	/** Direction the projectile was launched in. */
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction = FVector::ForwardVector;
+
+	/** Incremented on every launch so relaunches always replicate. */
+	UPROPERTY()
+	uint8 Generation = 0;
+
+	/** Launch speed of the projectile, in units per second. */
+	UPROPERTY()
+	float Speed = 0.0f;
+
+	/** Sequence number of the shot that launched the projectile, used to match it with a predicted copy. */
+	UPROPERTY()
+	uint16 ShotId = 0;
+
+	/** Whether the projectile is currently in flight or parked in its pool. */
+	UPROPERTY()
+	bool bActive = false;
+
+	/** Whether the projectile bounces off geometry instead of stopping at the first hit. */
+	UPROPERTY()
+	bool bBounces = false;
+};
 
 /**
  * Represents a projectile in the NeuroStrike game.
  * This class handles the movement, collision, and behavior of the projectile
  * when it interacts with other objects.
+ *
+ * Projectile scene queries are kept cheap: the collision sphere is a query-only body of the projectile channel
+ * that only blocks characters, world-static and world-dynamic geometry and physics bodies, generates no overlaps
+ * and never uses CCD, and the movement sweep is sub-stepped by distance, at most MaxSubSteps times a frame.
+ * Bouncing is opt-in per weapon and impulses are only applied to simulating actors tagged with ImpulseActorTag.
  */
 UCLASS(config=Game)
 class ANeuroStrikeProjectile : public AActor {
@@ -34,6 +82,24 @@ class ANeuroStrikeProjectile : public AActor {
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	UProjectileMovementComponent* ProjectileMovement;
 
+	/**
+	 * Activation state replicated to clients, driving visibility, collision and movement of pooled projectiles.
+	 */
+	UPROPERTY(ReplicatedUsing=OnRep_LaunchState)
+	FNeuroStrikeProjectileLaunchState LaunchState;
+
+	/** Pool this projectile is returned to on hit or expiry. Destroyed instead when unset. */
+	TWeakObjectPtr<UNeuroStrikeProjectilePoolSubsystem> OwningPool;
+
+	/** Timer returning the projectile once its lifespan has elapsed. */
+	FTimerHandle LifeSpanTimerHandle;
+
+	/** Stats of the weapon that launched the projectile, read when it hits. Only set with authority. */
+	TSharedPtr<const FNeuroStrikeWeaponStats> WeaponStats;
+
+	/** World time of the latest launch, to measure the flight time until the hit. */
+	float LaunchTime = 0.0f;
+
 public:
 	/**
 	 * Constructs an instance of ANeuroStrikeProjectile.
@@ -59,6 +125,101 @@ public:
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse,
 	           const FHitResult& Hit);
 
+	/**
+	 * Time in seconds a launched projectile stays in flight before it is released.
+	 * Replaces the actor lifespan so expired projectiles can be returned to their pool instead of being destroyed.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile)
+	float LifeSpan = 3.0f;
+
+	/**
+	 * Channels the projectile is also stopped by, on top of characters, world-static and world-dynamic geometry
+	 * and physics bodies.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=Collision)
+	TArray<TEnumAsByte<ECollisionChannel>> AdditionalBlockingChannels;
+
+	/**
+	 * Distance the projectile may travel in a single sweep. Frames covering more are split into sub-steps, so fast
+	 * projectiles follow gravity or bounces accurately while slow ones sweep once per frame.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=Collision, meta=(ClampMin="1"))
+	float MaxSubStepDistance = 500.0f;
+
+	/** Most sweeps the projectile runs in a single frame, whatever the distance it covers. */
+	UPROPERTY(EditDefaultsOnly, Category=Collision, meta=(ClampMin="1", ClampMax="25"))
+	int32 MaxSubSteps = 2;
+
+	/** Impulse applied per unit of projectile velocity to the physics bodies it hits. */
+	UPROPERTY(EditDefaultsOnly, Category=Collision, meta=(ClampMin="0"))
+	float ImpulseScale = 100.0f;
+
+	/** Tag an actor needs for projectiles to push its simulating physics bodies. */
+	static const FName ImpulseActorTag;
+
+	/** Applies the class's additional blocking channels to the collision sphere. */
+	virtual void PostInitializeComponents() override;
+
+	/**
+	 * Marks the projectile as owned by a pool, so releasing it parks it instead of destroying it.
+	 *
+	 * @param Pool The pool subsystem that owns this projectile.
+	 */
+	void SetOwningPool(UNeuroStrikeProjectilePoolSubsystem* Pool);
+
+	/**
+	 * Checks whether a projectile could be placed at the given location without starting inside blocking geometry.
+	 *
+	 * @param Location The candidate launch location.
+	 * @return true if the collision sphere does not overlap anything it would block against.
+	 */
+	bool CanLaunchFrom(const FVector& Location) const;
+
+	/**
+	 * Launches the projectile from the given location, restoring visibility, collision and velocity.
+	 * Must be called with authority; clients follow through the replicated launch state.
+	 *
+	 * @param Location The world location the projectile starts from.
+	 * @param Rotation The direction the projectile travels in.
+	 * @param ShotId Sequence number of the shot that launched the projectile.
+	 * @param Stats Stats of the firing weapon, overriding the speed, lifespan and damage of the projectile.
+	 *              The class defaults are used when null.
+	 */
+	void Launch(const FVector& Location, const FRotator& Rotation, uint16 ShotId = 0,
+	            const TSharedPtr<const FNeuroStrikeWeaponStats>& Stats = nullptr);
+
+	/**
+	 * Stops the projectile and hides it, leaving it ready to be launched again.
+	 * Must be called with authority; clients follow through the replicated launch state.
+	 */
+	void Deactivate();
+
+	/**
+	 * Ends the flight of the projectile, returning it to its pool or destroying it when it is not pooled.
+	 */
+	void Release();
+
+	/**
+	 * Checks whether the projectile is currently in flight.
+	 *
+	 * @return true if the projectile has been launched and not yet released.
+	 */
+	bool IsLaunched() const {
+		return this->LaunchState.bActive;
+	}
+
+	/**
+	 * Checks whether this is a client-side predicted projectile.
+	 *
+	 * Predicted projectiles are spawned locally by the owning client for immediate feedback. They are never
+	 * replicated and never deal damage or apply impulses; the server's projectile remains authoritative.
+	 *
+	 * @return true if the projectile only exists on this client.
+	 */
+	bool IsCosmetic() const;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	/**
 	 * Retrieves the collision component of the projectile.
 	 * The collision component is used to handle interactions and collisions with other objects in the game world.
@@ -78,4 +239,35 @@ public:
 	UProjectileMovementComponent* GetProjectileMovement() const {
 		return this->ProjectileMovement;
 	}
+
+private:
+	/**
+	 * Applies the replicated launch state on clients.
+	 *
+	 * On the client that fired the shot the authoritative projectile stays hidden when a predicted copy with the
+	 * same shot id is already in flight, so the shot is shown once and without the round-trip delay.
+	 */
+	UFUNCTION()
+	void OnRep_LaunchState();
+
+	/**
+	 * Checks whether the owning client already predicted the shot that launched this projectile.
+	 *
+	 * @return true if the local instigator fired a predicted copy of this shot.
+	 */
+	bool WasPredictedLocally() const;
+
+	/**
+	 * Hands the character a predicted projectile hit to the latency subsystem, so FireToHealth follows the
+	 * projectile's trajectory rather than the aim ray. Only the local shooter's projectiles report.
+	 *
+	 * @param Victim The character the predicted projectile hit.
+	 */
+	void NotifyPredictedHit(const ANeuroStrikeCharacter* Victim) const;
+
+	/**
+	 * Brings visibility, collision and movement in line with the current launch state.
+	 * Shared by the authority and by clients receiving the replicated state.
+	 */
+	void ApplyLaunchState();
 };
@@ -0,0 +1,169 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeProjectilePoolSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeProjectile.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace NeuroStrikeProjectilePool {
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("NeuroStrike.ProjectilePool.Stats"),
+		TEXT("Logs hit, miss and high-water-mark counters of every projectile pool in the current world."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World) {
+			if (World != nullptr) {
+				if (const UNeuroStrikeProjectilePoolSubsystem* Pool = World->GetSubsystem<
+					UNeuroStrikeProjectilePoolSubsystem>()) {
+					Pool->LogPoolStats();
+				}
+			}
+		}));
+}
+
+void UNeuroStrikeProjectilePoolSubsystem::OnWorldBeginPlay(UWorld& InWorld) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Nothing has ticked yet, so resolving the classes here does not hitch gameplay.
+	for (const TSoftClassPtr<ANeuroStrikeProjectile>& ProjectileClass : this->PrewarmClasses) {
+		this->Prewarm(ProjectileClass.LoadSynchronous());
+	}
+}
+
+void UNeuroStrikeProjectilePoolSubsystem::Deinitialize() {
+	this->LogPoolStats();
+	this->Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNeuroStrikeProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UNeuroStrikeProjectilePoolSubsystem::Prewarm(TSubclassOf<ANeuroStrikeProjectile> ProjectileClass, int32 Count) {
+	if (ProjectileClass == nullptr) {
+		return;
+	}
+
+	if (Count < 0) {
+		Count = this->DefaultPrewarmCount;
+	}
+
+	FNeuroStrikeProjectilePool& Pool = this->Pools.FindOrAdd(ProjectileClass);
+	const int32 Missing = Count - Pool.Available.Num() - Pool.Stats.InUse;
+	if (Missing <= 0) {
+		return;
+	}
+
+	Pool.Available.Reserve(Pool.Available.Num() + Missing);
+	for (int32 Index = 0; Index < Missing; ++Index) {
+		ANeuroStrikeProjectile* Projectile = this->SpawnPooledProjectile(
+			ProjectileClass, FTransform::Identity, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Projectile == nullptr) {
+			break;
+		}
+
+		Projectile->Deactivate();
+		Pool.Available.Add(Projectile);
+	}
+
+	Pool.Stats.Available = Pool.Available.Num();
+}
+
+ANeuroStrikeProjectile* UNeuroStrikeProjectilePoolSubsystem::Acquire(TSubclassOf<ANeuroStrikeProjectile> ProjectileClass,
+                                                                     const FVector& Location, const FRotator& Rotation,
+                                                                     APawn* Instigator, uint16 ShotId,
+                                                                     const TSharedPtr<const FNeuroStrikeWeaponStats>& Stats) {
+	if (ProjectileClass == nullptr) {
+		return nullptr;
+	}
+
+	FNeuroStrikeProjectilePool& Pool = this->Pools.FindOrAdd(ProjectileClass);
+
+	ANeuroStrikeProjectile* Projectile = nullptr;
+	while (Projectile == nullptr && Pool.Available.Num() > 0) {
+		Projectile = Pool.Available.Pop(false);
+		if (!IsValid(Projectile)) {
+			Projectile = nullptr;
+		}
+	}
+
+	if (Projectile != nullptr) {
+		if (!Projectile->CanLaunchFrom(Location)) {
+			Pool.Available.Add(Projectile);
+			Pool.Stats.Available = Pool.Available.Num();
+			return nullptr;
+		}
+
+		Pool.Stats.Hits++;
+	} else {
+		Projectile = this->SpawnPooledProjectile(ProjectileClass, FTransform(Rotation, Location),
+		                                         ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding);
+		if (Projectile == nullptr) {
+			return nullptr;
+		}
+
+		Pool.Stats.Misses++;
+	}
+
+	Projectile->SetInstigator(Instigator);
+	Projectile->Launch(Location, Rotation, ShotId, Stats);
+
+	INC_DWORD_STAT(STAT_NeuroStrike_LiveProjectiles);
+	Pool.Stats.InUse++;
+	Pool.Stats.Available = Pool.Available.Num();
+	Pool.Stats.HighWaterMark = FMath::Max(Pool.Stats.HighWaterMark, Pool.Stats.InUse);
+
+	return Projectile;
+}
+
+void UNeuroStrikeProjectilePoolSubsystem::Release(ANeuroStrikeProjectile* Projectile) {
+	if (!IsValid(Projectile) || !Projectile->IsLaunched()) {
+		return;
+	}
+
+	Projectile->Deactivate();
+	Projectile->SetInstigator(nullptr);
+
+	FNeuroStrikeProjectilePool& Pool = this->Pools.FindOrAdd(Projectile->GetClass());
+	Pool.Available.Add(Projectile);
+	DEC_DWORD_STAT(STAT_NeuroStrike_LiveProjectiles);
+	Pool.Stats.InUse = FMath::Max(Pool.Stats.InUse - 1, 0);
+	Pool.Stats.Available = Pool.Available.Num();
+}
+
+FNeuroStrikeProjectilePoolStats UNeuroStrikeProjectilePoolSubsystem::GetPoolStats(
+	TSubclassOf<ANeuroStrikeProjectile> ProjectileClass) const {
+	const FNeuroStrikeProjectilePool* Pool = this->Pools.Find(ProjectileClass);
+	return Pool != nullptr ? Pool->Stats : FNeuroStrikeProjectilePoolStats();
+}
+
+void UNeuroStrikeProjectilePoolSubsystem::LogPoolStats() const {
+	for (const TPair<TSubclassOf<ANeuroStrikeProjectile>, FNeuroStrikeProjectilePool>& Entry : this->Pools) {
+		const FNeuroStrikeProjectilePoolStats& Stats = Entry.Value.Stats;
+		UE_LOG(LogNeuroStrike, Log,
+		       TEXT("Projectile pool %s: hits=%d misses=%d in-use=%d available=%d high-water-mark=%d"),
+		       *GetNameSafe(Entry.Key.Get()), Stats.Hits, Stats.Misses, Stats.InUse, Stats.Available,
+		       Stats.HighWaterMark);
+	}
+}
+
+ANeuroStrikeProjectile* UNeuroStrikeProjectilePoolSubsystem::SpawnPooledProjectile(
+	TSubclassOf<ANeuroStrikeProjectile> ProjectileClass, const FTransform& Transform,
+	ESpawnActorCollisionHandlingMethod CollisionHandling) {
+	UWorld* World = this->GetWorld();
+	if (World == nullptr) {
+		return nullptr;
+	}
+
+	FActorSpawnParameters ActorSpawnParams;
+	ActorSpawnParams.SpawnCollisionHandlingOverride = CollisionHandling;
+
+	ANeuroStrikeProjectile* Projectile = World->SpawnActor<ANeuroStrikeProjectile>(
+		ProjectileClass, Transform, ActorSpawnParams);
+	if (Projectile != nullptr) {
+		Projectile->SetOwningPool(this);
+	}
+
+	return Projectile;
+}
@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikeProjectilePoolSubsystem.generated.h"
+
+class ANeuroStrikeProjectile;
+struct FNeuroStrikeWeaponStats;
+
+/**
+ * Usage counters of a single projectile pool.
+ *
+ * A hit means a shot was served by an already warm projectile, a miss means the pool was empty and a new
+ * actor had to be spawned. The high-water mark is the largest number of projectiles that were in flight at
+ * the same time, which is the value the pool should be pre-warmed to on a given map.
+ */
+USTRUCT(BlueprintType)
+struct FNeuroStrikeProjectilePoolStats {
+	GENERATED_BODY()
+
+	/** Number of acquisitions served from the pool without spawning. */
+	UPROPERTY(BlueprintReadOnly, Category=Pool)
+	int32 Hits = 0;
+
+	/** Number of acquisitions that had to spawn a new projectile because the pool was empty. */
+	UPROPERTY(BlueprintReadOnly, Category=Pool)
+	int32 Misses = 0;
+
+	/** Projectiles currently handed out and in flight. */
+	UPROPERTY(BlueprintReadOnly, Category=Pool)
+	int32 InUse = 0;
+
+	/** Projectiles currently parked in the pool and ready to be handed out. */
+	UPROPERTY(BlueprintReadOnly, Category=Pool)
+	int32 Available = 0;
+
+	/** Largest value InUse has reached since the pool was created. */
+	UPROPERTY(BlueprintReadOnly, Category=Pool)
+	int32 HighWaterMark = 0;
+};
+
+/** Parked projectiles and counters of one projectile class. */
+USTRUCT()
+struct FNeuroStrikeProjectilePool {
+	GENERATED_BODY()
+
+	/** Deactivated projectiles ready to be handed out. */
+	UPROPERTY()
+	TArray<TObjectPtr<ANeuroStrikeProjectile>> Available;
+
+	/** Usage counters of this pool. */
+	UPROPERTY()
+	FNeuroStrikeProjectilePoolStats Stats;
+};
+
+/**
+ * World subsystem that recycles projectile actors instead of spawning and destroying one per shot.
+ *
+ * Projectiles are pre-warmed per class, handed out on fire and returned on hit or expiry. Returned projectiles
+ * keep their actor and components alive; only movement, collision and visibility are reset, which removes the
+ * actor construction and garbage collection cost from the fire path.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikeProjectilePoolSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Pre-warms the pool of every class in PrewarmClasses, so the first pickup of a weapon does not spawn its pool.
+	 */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/**
+	 * Logs the final counters of every pool when the world is torn down, so pool sizes can be tuned per map.
+	 */
+	virtual void Deinitialize() override;
+
+	/**
+	 * Makes sure the pool of the given class holds at least the requested number of projectiles.
+	 *
+	 * Projectiles that are already in flight count towards the total, so calling this repeatedly with the same
+	 * count only spawns the difference.
+	 *
+	 * @param ProjectileClass The projectile class to pre-warm.
+	 * @param Count The number of projectiles the pool should own. Uses DefaultPrewarmCount when negative.
+	 */
+	void Prewarm(TSubclassOf<ANeuroStrikeProjectile> ProjectileClass, int32 Count = -1);
+
+	/**
+	 * Hands out an active projectile of the given class at the requested location.
+	 *
+	 * Falls back to spawning a new projectile when the pool is empty. Mirrors the
+	 * AdjustIfPossibleButDontSpawnIfColliding spawn rule, so nothing is returned when the location is blocked.
+	 *
+	 * @param ProjectileClass The projectile class to hand out.
+	 * @param Location The world location the projectile starts from.
+	 * @param Rotation The direction the projectile is launched in.
+	 * @param Instigator The pawn responsible for the shot.
+	 * @param ShotId Sequence number of the shot, replicated with the launch state.
+	 * @param Stats Stats of the firing weapon, passed on to the projectile.
+	 * @return The launched projectile, or nullptr if it could not be placed.
+	 */
+	ANeuroStrikeProjectile* Acquire(TSubclassOf<ANeuroStrikeProjectile> ProjectileClass, const FVector& Location,
+	                                const FRotator& Rotation, APawn* Instigator, uint16 ShotId = 0,
+	                                const TSharedPtr<const FNeuroStrikeWeaponStats>& Stats = nullptr);
+
+	/**
+	 * Deactivates a projectile and parks it in the pool of its class.
+	 *
+	 * @param Projectile The projectile to return. Must have been handed out by this subsystem.
+	 */
+	void Release(ANeuroStrikeProjectile* Projectile);
+
+	/**
+	 * Retrieves the usage counters of the pool of the given class.
+	 *
+	 * @param ProjectileClass The projectile class to query.
+	 * @return The counters of that pool, zeroed if the class was never pooled.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Projectile|Pool")
+	FNeuroStrikeProjectilePoolStats GetPoolStats(TSubclassOf<ANeuroStrikeProjectile> ProjectileClass) const;
+
+	/** Writes the counters of every pool to the log. */
+	void LogPoolStats() const;
+
+	/** Number of projectiles pre-warmed for a class when the caller does not provide its own count. */
+	UPROPERTY(config)
+	int32 DefaultPrewarmCount = 32;
+
+	/** Projectile classes pre-warmed with DefaultPrewarmCount projectiles as soon as the world begins play. */
+	UPROPERTY(config)
+	TArray<TSoftClassPtr<ANeuroStrikeProjectile>> PrewarmClasses;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * Spawns a new projectile owned by this subsystem.
+	 *
+	 * @param ProjectileClass The class to spawn.
+	 * @param Transform The spawn transform.
+	 * @param CollisionHandling How to handle spawning inside blocking geometry.
+	 * @return The spawned projectile, or nullptr if spawning failed.
+	 */
+	ANeuroStrikeProjectile* SpawnPooledProjectile(TSubclassOf<ANeuroStrikeProjectile> ProjectileClass,
+	                                              const FTransform& Transform,
+	                                              ESpawnActorCollisionHandlingMethod CollisionHandling);
+
+	/** Pools keyed by projectile class. */
+	UPROPERTY()
+	TMap<TSubclassOf<ANeuroStrikeProjectile>, FNeuroStrikeProjectilePool> Pools;
+};
@@ -0,0 +1,205 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeReplicationGraph.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "NeuroStrikeProjectile.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+void UNeuroStrikeReplicationGraph::ResetGameWorldState() {
+	Super::ResetGameWorldState();
+
+	this->ActorsWithoutNetConnection.Reset();
+}
+
+void UNeuroStrikeReplicationGraph::InitGlobalActorClassSettings() {
+	Super::InitGlobalActorClassSettings();
+
+	this->ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), ENeuroStrikeClassRepNodeMapping::RelevantAllConnections);
+	this->ClassRepNodePolicies.Set(APlayerState::StaticClass(), ENeuroStrikeClassRepNodeMapping::RelevantAllConnections);
+	this->ClassRepNodePolicies.Set(APlayerController::StaticClass(),
+	                               ENeuroStrikeClassRepNodeMapping::RelevantOwnerConnection);
+	this->ClassRepNodePolicies.Set(ANeuroStrikeCharacter::StaticClass(),
+	                               ENeuroStrikeClassRepNodeMapping::Spatialize_Dynamic);
+	this->ClassRepNodePolicies.Set(ANeuroStrikeProjectile::StaticClass(),
+	                               ENeuroStrikeClassRepNodeMapping::Spatialize_Dynamic);
+
+	const ANeuroStrikeCharacter* CharacterDefaults = GetDefault<ANeuroStrikeCharacter>();
+	FClassReplicationInfo CharacterInfo;
+	CharacterInfo.SetCullDistanceSquared(FMath::Square(this->CharacterCullDistance));
+	CharacterInfo.ReplicationPeriodFrame = this->GetReplicationPeriodFrameForFrequency(
+		CharacterDefaults->NetUpdateFrequency);
+	this->GlobalActorReplicationInfoMap.SetClassInfo(ANeuroStrikeCharacter::StaticClass(), CharacterInfo);
+
+	const ANeuroStrikeProjectile* ProjectileDefaults = GetDefault<ANeuroStrikeProjectile>();
+	FClassReplicationInfo ProjectileInfo;
+	ProjectileInfo.SetCullDistanceSquared(FMath::Square(this->ProjectileCullDistance));
+	ProjectileInfo.ReplicationPeriodFrame = this->GetReplicationPeriodFrameForFrequency(
+		ProjectileDefaults->NetUpdateFrequency);
+	this->GlobalActorReplicationInfoMap.SetClassInfo(ANeuroStrikeProjectile::StaticClass(), ProjectileInfo);
+
+	// Character multicasts must not open channels on connections for which the character was culled,
+	// otherwise they would still be broadcast to the whole server.
+	this->RPC_Multicast_OpenChannelForClass.Set(ANeuroStrikeCharacter::StaticClass(), false);
+}
+
+void UNeuroStrikeReplicationGraph::InitGlobalGraphNodes() {
+	Super::InitGlobalGraphNodes();
+
+	this->GridNode = this->CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	this->GridNode->CellSize = this->GridCellSize;
+	this->GridNode->SpatialBias = this->SpatialBias;
+	this->AddGlobalGraphNode(this->GridNode);
+
+	this->AlwaysRelevantNode = this->CreateNewNode<UReplicationGraphNode_ActorList>();
+	this->AddGlobalGraphNode(this->AlwaysRelevantNode);
+}
+
+void UNeuroStrikeReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) {
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = this->CreateNewNode<
+		UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	this->AddConnectionGraphNode(Node, RepGraphConnection);
+
+	this->ConnectionAlwaysRelevantNodes.Add(RepGraphConnection->NetConnection, Node);
+}
+
+void UNeuroStrikeReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection) {
+	this->ConnectionAlwaysRelevantNodes.Remove(NetConnection);
+
+	Super::RemoveClientConnection(NetConnection);
+}
+
+void UNeuroStrikeReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo,
+                                                               FGlobalActorReplicationInfo& GlobalInfo) {
+	switch (this->GetMappingPolicy(ActorInfo.Class)) {
+	case ENeuroStrikeClassRepNodeMapping::RelevantAllConnections:
+		this->AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case ENeuroStrikeClassRepNodeMapping::RelevantOwnerConnection:
+		// The owning connection is usually assigned after the actor is spawned.
+		this->ActorsWithoutNetConnection.Add(ActorInfo.Actor);
+		break;
+	case ENeuroStrikeClassRepNodeMapping::Spatialize_Static:
+		this->GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case ENeuroStrikeClassRepNodeMapping::Spatialize_Dynamic:
+		this->GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case ENeuroStrikeClassRepNodeMapping::Spatialize_Dormancy:
+		this->GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+void UNeuroStrikeReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) {
+	switch (this->GetMappingPolicy(ActorInfo.Class)) {
+	case ENeuroStrikeClassRepNodeMapping::RelevantAllConnections:
+		this->AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case ENeuroStrikeClassRepNodeMapping::RelevantOwnerConnection:
+		if (this->ActorsWithoutNetConnection.RemoveSwap(ActorInfo.Actor) == 0) {
+			// The connection may already be gone, so look the actor up in every owner-only node.
+			for (const auto& Pair : this->ConnectionAlwaysRelevantNodes) {
+				Pair.Value->NotifyRemoveNetworkActor(ActorInfo, false);
+			}
+		}
+		break;
+	case ENeuroStrikeClassRepNodeMapping::Spatialize_Static:
+		this->GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case ENeuroStrikeClassRepNodeMapping::Spatialize_Dynamic:
+		this->GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case ENeuroStrikeClassRepNodeMapping::Spatialize_Dormancy:
+		this->GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+int32 UNeuroStrikeReplicationGraph::ServerReplicateActors(float DeltaSeconds) {
+	for (int32 Index = this->ActorsWithoutNetConnection.Num() - 1; Index >= 0; --Index) {
+		AActor* Actor = this->ActorsWithoutNetConnection[Index];
+		if (Actor == nullptr) {
+			this->ActorsWithoutNetConnection.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		UReplicationGraphNode_AlwaysRelevant_ForConnection* Node = this->GetAlwaysRelevantNodeForConnection(
+			Actor->GetNetConnection());
+		if (Node == nullptr) {
+			continue;
+		}
+
+		Node->NotifyAddNetworkActor(FNewReplicatedActorInfo(Actor));
+		this->ActorsWithoutNetConnection.RemoveAtSwap(Index, 1, false);
+	}
+
+	return Super::ServerReplicateActors(DeltaSeconds);
+}
+
+void UNeuroStrikeReplicationGraph::SetActorNetUpdateFrequency(AActor* Actor, float Frequency) {
+	if (Actor == nullptr || !Actor->HasAuthority() || Actor->NetUpdateFrequency == Frequency) {
+		return;
+	}
+
+	Actor->NetUpdateFrequency = Frequency;
+
+	const UWorld* World = Actor->GetWorld();
+	const UNetDriver* NetDriver = World != nullptr ? World->GetNetDriver() : nullptr;
+	if (NetDriver == nullptr) {
+		return;
+	}
+
+	if (UNeuroStrikeReplicationGraph* Graph = Cast<UNeuroStrikeReplicationGraph>(NetDriver->GetReplicationDriver())) {
+		if (FGlobalActorReplicationInfo* Info = Graph->GlobalActorReplicationInfoMap.Find(Actor)) {
+			Info->Settings.ReplicationPeriodFrame = Graph->GetReplicationPeriodFrameForFrequency(Frequency);
+		}
+	}
+}
+
+ENeuroStrikeClassRepNodeMapping UNeuroStrikeReplicationGraph::GetMappingPolicy(const UClass* Class) {
+	if (const ENeuroStrikeClassRepNodeMapping* Mapping = this->ClassRepNodePolicies.Get(Class)) {
+		return *Mapping;
+	}
+
+	// Classes without an explicit policy are routed from the replication flags of their defaults.
+	const AActor* Defaults = GetDefault<AActor>(const_cast<UClass*>(Class));
+	ENeuroStrikeClassRepNodeMapping Mapping = ENeuroStrikeClassRepNodeMapping::Spatialize_Dynamic;
+	if (!Defaults->GetIsReplicated()) {
+		Mapping = ENeuroStrikeClassRepNodeMapping::NotRouted;
+	} else if (Defaults->bAlwaysRelevant) {
+		Mapping = ENeuroStrikeClassRepNodeMapping::RelevantAllConnections;
+	} else if (Defaults->bOnlyRelevantToOwner) {
+		Mapping = ENeuroStrikeClassRepNodeMapping::RelevantOwnerConnection;
+	} else if (Defaults->NetDormancy > DORM_Awake) {
+		Mapping = ENeuroStrikeClassRepNodeMapping::Spatialize_Dormancy;
+	} else if (Defaults->GetRootComponent() != nullptr
+		&& Defaults->GetRootComponent()->Mobility == EComponentMobility::Static) {
+		Mapping = ENeuroStrikeClassRepNodeMapping::Spatialize_Static;
+	}
+
+	this->ClassRepNodePolicies.Set(Class, Mapping);
+	return Mapping;
+}
+
+UReplicationGraphNode_AlwaysRelevant_ForConnection* UNeuroStrikeReplicationGraph::GetAlwaysRelevantNodeForConnection(
+	UNetConnection* Connection) const {
+	if (Connection == nullptr) {
+		return nullptr;
+	}
+
+	const TObjectPtr<UReplicationGraphNode_AlwaysRelevant_ForConnection>* Node = this->ConnectionAlwaysRelevantNodes.
+		Find(Connection);
+	return Node != nullptr ? Node->Get() : nullptr;
+}
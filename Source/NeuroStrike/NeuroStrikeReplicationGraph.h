@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "NeuroStrikeReplicationGraph.generated.h"
+
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+class UReplicationGraphNode_GridSpatialization2D;
+
+/** How actors of a class are routed into the replication graph. */
+enum class ENeuroStrikeClassRepNodeMapping : uint8 {
+	/** Not added to any node. Only replicates if something adds it explicitly. */
+	NotRouted,
+
+	/** Replicated to every connection, regardless of distance. */
+	RelevantAllConnections,
+
+	/** Replicated only to the connection that owns the actor. */
+	RelevantOwnerConnection,
+
+	/** Spatialized into grid cells once; the actor never moves. */
+	Spatialize_Static,
+
+	/** Spatialized into grid cells every frame according to its current location. */
+	Spatialize_Dynamic,
+
+	/** Spatialized as static while dormant and as dynamic while awake. */
+	Spatialize_Dormancy,
+};
+
+/**
+ * Replication graph driver for NeuroStrike.
+ *
+ * Replaces the default per-actor, per-connection relevancy evaluation. Characters and projectiles live in a
+ * spatialized 2D grid, so each connection only gathers the actors in the cells around its viewer; game state
+ * and player states are kept in a single always-relevant list, and controllers are only gathered for their
+ * owning connection. Server cost therefore scales with local actor density instead of with the number of
+ * actors times the number of connections.
+ *
+ * Multicast RPCs of characters honour the character cull distance and do not open channels on their own, so they
+ * only reach connections for which the character is within audible or visible range. Remote fire effects are
+ * replicated as the character's fire state instead, which follows the same culling.
+ */
+UCLASS(transient, config=Engine)
+class NEUROSTRIKE_API UNeuroStrikeReplicationGraph : public UReplicationGraph {
+	GENERATED_BODY()
+
+public:
+	virtual void ResetGameWorldState() override;
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo,
+	                                         FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+	/**
+	 * Changes how often an actor is considered for replication.
+	 *
+	 * The replication graph reads the replication period from its own per-actor settings rather than from
+	 * AActor::NetUpdateFrequency, so both are updated; the actor value keeps the default net driver in sync.
+	 *
+	 * @param Actor The replicated actor. Only has an effect with authority.
+	 * @param Frequency The new update frequency, in updates per second.
+	 */
+	static void SetActorNetUpdateFrequency(AActor* Actor, float Frequency);
+
+	/** Edge length in world units of a spatialization grid cell. */
+	UPROPERTY(config)
+	float GridCellSize = 10000.0f;
+
+	/** World-space offset applied to the grid so that every playable location maps to a positive cell. */
+	UPROPERTY(config)
+	FVector2D SpatialBias = FVector2D(-150000.0f, -150000.0f);
+
+	/** Distance beyond which characters, and their multicast effects, are not replicated to a connection. */
+	UPROPERTY(config)
+	float CharacterCullDistance = 15000.0f;
+
+	/** Distance beyond which projectiles are not replicated to a connection. */
+	UPROPERTY(config)
+	float ProjectileCullDistance = 10000.0f;
+
+private:
+	/**
+	 * Determines how actors of the given class are routed, caching the answer per class.
+	 *
+	 * @param Class The actor class to route.
+	 * @return The routing policy of the class.
+	 */
+	ENeuroStrikeClassRepNodeMapping GetMappingPolicy(const UClass* Class);
+
+	/**
+	 * Retrieves the always-relevant node of a client connection.
+	 *
+	 * @param Connection The client connection.
+	 * @return The node, or nullptr if the connection has not been initialized.
+	 */
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* GetAlwaysRelevantNodeForConnection(
+		UNetConnection* Connection) const;
+
+	/** Grid node holding every spatialized actor. */
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+	/** Node holding actors replicated to every connection. */
+	UPROPERTY()
+	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+	/** Owner-only nodes of every client connection. */
+	UPROPERTY()
+	TMap<TObjectPtr<UNetConnection>, TObjectPtr<UReplicationGraphNode_AlwaysRelevant_ForConnection>>
+	ConnectionAlwaysRelevantNodes;
+
+	/** Owner-relevant actors whose owning connection was not known yet when they were added. */
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> ActorsWithoutNetConnection;
+
+	/** Routing policy per actor class. */
+	TClassMap<ENeuroStrikeClassRepNodeMapping> ClassRepNodePolicies;
+};
@@ -0,0 +1,139 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeSignificanceSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "TP_WeaponComponent.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+
+bool UNeuroStrikeSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UNeuroStrikeSignificanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
+	if (!Super::ShouldCreateSubsystem(Outer)) {
+		return false;
+	}
+
+	// Dedicated servers have no viewer to rate characters against.
+	return !IsRunningDedicatedServer();
+}
+
+TStatId UNeuroStrikeSignificanceSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNeuroStrikeSignificanceSubsystem, STATGROUP_NeuroStrike);
+}
+
+void UNeuroStrikeSignificanceSubsystem::OnWorldBeginPlay(UWorld& InWorld) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(&InWorld)) {
+		FAnimationBudgetAllocatorParameters Parameters;
+		Parameters.BudgetInMs = this->AnimationBudgetMs;
+		Allocator->SetParameters(Parameters);
+		Allocator->SetEnabled(true);
+	}
+}
+
+void UNeuroStrikeSignificanceSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	this->TimeSinceUpdate += DeltaTime;
+	if (this->TimeSinceUpdate < this->UpdateInterval) {
+		return;
+	}
+	this->TimeSinceUpdate = 0.0f;
+
+	UWorld* World = this->GetWorld();
+	if (World->GetNetMode() == NM_DedicatedServer) {
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It) {
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController == nullptr || !PlayerController->IsLocalController()) {
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ViewLocations.Add(ViewLocation);
+	}
+
+	if (ViewLocations.Num() == 0) {
+		return;
+	}
+
+	for (TActorIterator<ANeuroStrikeCharacter> It(World); It; ++It) {
+		ANeuroStrikeCharacter* Character = *It;
+		if (Character->IsLocallyControlled() || Character->HasAuthority()) {
+			continue;
+		}
+
+		this->ApplySignificance(Character, this->GetSignificance(Character, ViewLocations));
+	}
+}
+
+UNeuroStrikeSignificanceSubsystem::ESignificance UNeuroStrikeSignificanceSubsystem::GetSignificance(
+	const ANeuroStrikeCharacter* Character, TConstArrayView<FVector> ViewLocations) const {
+	const USkeletalMeshComponent* Mesh = Character->GetMesh();
+	if (Mesh != nullptr && !Mesh->WasRecentlyRendered(this->UpdateInterval)) {
+		return ESignificance::Hidden;
+	}
+
+	const FVector Location = Character->GetActorLocation();
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+	for (const FVector& ViewLocation : ViewLocations) {
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(Location, ViewLocation));
+	}
+
+	if (ClosestDistanceSquared <= FMath::Square(this->NearDistance)) {
+		return ESignificance::Near;
+	}
+	if (ClosestDistanceSquared <= FMath::Square(this->MidDistance)) {
+		return ESignificance::Mid;
+	}
+	return ESignificance::Far;
+}
+
+void UNeuroStrikeSignificanceSubsystem::ApplySignificance(ANeuroStrikeCharacter* Character,
+                                                          ESignificance Significance) const {
+	float TickInterval = 0.0f;
+	float BudgetSignificance = 1.0f;
+	switch (Significance) {
+	case ESignificance::Mid:
+		TickInterval = this->MidTickInterval;
+		BudgetSignificance = 0.5f;
+		break;
+	case ESignificance::Far:
+		TickInterval = this->FarTickInterval;
+		BudgetSignificance = 0.25f;
+		break;
+	case ESignificance::Hidden:
+		TickInterval = this->HiddenTickInterval;
+		BudgetSignificance = 0.0f;
+		break;
+	default:
+		break;
+	}
+
+	if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement()) {
+		Movement->SetComponentTickInterval(TickInterval);
+	}
+	if (UTP_WeaponComponent* Weapon = Character->WeaponComponent) {
+		Weapon->SetComponentTickInterval(TickInterval);
+	}
+
+	// The budgeted mesh is ticked by the allocator, which trades its update rate against the frame budget.
+	USkeletalMeshComponentBudgeted* Mesh = Cast<USkeletalMeshComponentBudgeted>(Character->GetMesh());
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(this->GetWorld());
+	if (Mesh != nullptr && Allocator != nullptr && Mesh->GetAnimationBudgetHandle() != INDEX_NONE) {
+		Allocator->SetComponentSignificance(Mesh, BudgetSignificance);
+	}
+}
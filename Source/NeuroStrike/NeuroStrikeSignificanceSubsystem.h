@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikeSignificanceSubsystem.generated.h"
+
+class ANeuroStrikeCharacter;
+
+/**
+ * Client-side subsystem that lowers the tick rate of other players' characters by their significance.
+ *
+ * A few times per second every character that is not controlled on this machine is rated by its distance to
+ * the nearest local viewer and by whether it was rendered recently. Its movement and weapon components then
+ * tick at the interval of that rating, and the rating is handed to the animation budget allocator, which
+ * decides how often the third-person mesh is evaluated within AnimationBudgetMs. Distant or hidden characters
+ * therefore cost a fraction of a frame. Locally controlled characters and every character on the server keep
+ * ticking every frame, since movement prediction and server moves depend on it.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikeSignificanceSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Rates every remote character once the update interval has elapsed.
+	 *
+	 * @param DeltaTime Time elapsed since the previous frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Applies the animation budget of this world to its budget allocator. */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Game thread milliseconds per frame the animation budget allocator may spend on budgeted meshes. */
+	UPROPERTY(config)
+	float AnimationBudgetMs = 1.0f;
+
+	/** Seconds between two significance updates. */
+	UPROPERTY(config)
+	float UpdateInterval = 0.25f;
+
+	/** Distance up to which rendered characters tick every frame. */
+	UPROPERTY(config)
+	float NearDistance = 2500.0f;
+
+	/** Distance up to which rendered characters tick at MidTickInterval; beyond it they tick at FarTickInterval. */
+	UPROPERTY(config)
+	float MidDistance = 6000.0f;
+
+	/** Tick interval of rendered characters between NearDistance and MidDistance. */
+	UPROPERTY(config)
+	float MidTickInterval = 1.0f / 30.0f;
+
+	/** Tick interval of rendered characters beyond MidDistance. */
+	UPROPERTY(config)
+	float FarTickInterval = 0.1f;
+
+	/** Tick interval of characters that have not been rendered recently, regardless of distance. */
+	UPROPERTY(config)
+	float HiddenTickInterval = 0.25f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+private:
+	/** How much a remote character matters to the local viewers, from most to least significant. */
+	enum class ESignificance : uint8 {
+		Near,
+		Mid,
+		Far,
+		Hidden,
+	};
+
+	/**
+	 * Rates a remote character.
+	 *
+	 * @param Character The character to rate.
+	 * @param ViewLocations Viewpoints of the local players.
+	 * @return The significance of the character.
+	 */
+	ESignificance GetSignificance(const ANeuroStrikeCharacter* Character, TConstArrayView<FVector> ViewLocations) const;
+
+	/**
+	 * Throttles the per-frame work of a character according to its significance.
+	 *
+	 * @param Character The character to throttle.
+	 * @param Significance The significance of the character.
+	 */
+	void ApplySignificance(ANeuroStrikeCharacter* Character, ESignificance Significance) const;
+
+	/** Time accumulated since the previous significance update. */
+	float TimeSinceUpdate = 0.0f;
+};
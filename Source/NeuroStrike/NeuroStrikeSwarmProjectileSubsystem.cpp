@@ -0,0 +1,230 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeSwarmProjectileSubsystem.h"
+#include "NeuroStrike.h"
+#include "NeuroStrikeCharacter.h"
+#include "NeuroStrikeDamageSubsystem.h"
+#include "NeuroStrikePreloadSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Swarm Projectiles"), STAT_NeuroStrike_SwarmProjectiles, STATGROUP_NeuroStrike);
+
+void UNeuroStrikeSwarmProjectileSubsystem::Deinitialize() {
+	SET_DWORD_STAT(STAT_NeuroStrike_SwarmProjectiles, 0);
+
+	this->Positions.Empty();
+	this->Velocities.Empty();
+	this->Lifetimes.Empty();
+	this->Damages.Empty();
+	this->Instigators.Empty();
+	this->CosmeticFlags.Empty();
+	this->SweepHits.Empty();
+	this->IgnoredActors.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNeuroStrikeSwarmProjectileSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UNeuroStrikeSwarmProjectileSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UNeuroStrikeSwarmProjectileSubsystem, STATGROUP_NeuroStrike);
+}
+
+bool UNeuroStrikeSwarmProjectileSubsystem::SpawnProjectile(ANeuroStrikeCharacter* Instigator, const FVector& Location,
+                                                           const FVector& Velocity, float Lifetime, float Damage,
+                                                           bool bCosmetic) {
+	if (this->Positions.Num() >= this->MaxProjectiles || Lifetime <= 0.0f) {
+		return false;
+	}
+
+	if (!this->bRenderInitialized) {
+		this->CreateRenderComponent();
+	}
+
+	this->Positions.Add(Location);
+	this->Velocities.Add(Velocity);
+	this->Lifetimes.Add(Lifetime);
+	this->Damages.Add(bCosmetic ? 0.0f : Damage);
+	this->Instigators.Add(Instigator);
+	this->CosmeticFlags.Add(bCosmetic);
+
+	INC_DWORD_STAT(STAT_NeuroStrike_SwarmProjectiles);
+	return true;
+}
+
+void UNeuroStrikeSwarmProjectileSubsystem::Tick(float DeltaTime) {
+	Super::Tick(DeltaTime);
+
+	if (this->Positions.Num() > 0) {
+		this->Simulate(DeltaTime);
+		this->ResolveHits();
+	}
+
+	this->UpdateRenderInstances();
+}
+
+void UNeuroStrikeSwarmProjectileSubsystem::Simulate(float DeltaTime) {
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Swarm Simulate", STAT_NeuroStrike_SwarmSimulate);
+
+	const UWorld* World = this->GetWorld();
+	const int32 NumProjectiles = this->Positions.Num();
+	const int32 ChunkSize = FMath::Max(this->ProjectilesPerTask, 1);
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumProjectiles, ChunkSize);
+	const FVector Gravity(0.0f, 0.0f, World->GetGravityZ() * this->GravityScale);
+	const ECollisionChannel Channel = this->TraceChannel;
+
+	this->SweepHits.SetNum(NumProjectiles, false);
+
+	// Weak pointers are resolved on the game thread; the tasks only see the raw actors to ignore.
+	this->IgnoredActors.SetNumUninitialized(NumProjectiles, false);
+	for (int32 Index = 0; Index < NumProjectiles; ++Index) {
+		this->IgnoredActors[Index] = this->Instigators[Index].Get();
+	}
+
+	FVector* PositionData = this->Positions.GetData();
+	FVector* VelocityData = this->Velocities.GetData();
+	float* LifetimeData = this->Lifetimes.GetData();
+	FHitResult* HitData = this->SweepHits.GetData();
+	const AActor* const* IgnoredActorData = this->IgnoredActors.GetData();
+
+	// The game thread waits for the whole batch, so the scene cannot change while the tasks query it.
+	ParallelFor(NumChunks, [=](int32 ChunkIndex) {
+		const int32 Begin = ChunkIndex * ChunkSize;
+		const int32 End = FMath::Min(Begin + ChunkSize, NumProjectiles);
+
+		for (int32 Index = Begin; Index < End; ++Index) {
+			VelocityData[Index] += Gravity * DeltaTime;
+			LifetimeData[Index] -= DeltaTime;
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(NeuroStrikeSwarm), false);
+		for (int32 Index = Begin; Index < End; ++Index) {
+			const FVector Start = PositionData[Index];
+			const FVector Target = Start + VelocityData[Index] * DeltaTime;
+
+			QueryParams.ClearIgnoredActors();
+			QueryParams.AddIgnoredActor(IgnoredActorData[Index]);
+
+			FHitResult& Hit = HitData[Index];
+			Hit.Reset(1.0f, false);
+			World->LineTraceSingleByChannel(Hit, Start, Target, Channel, QueryParams);
+
+			PositionData[Index] = Hit.bBlockingHit ? Hit.ImpactPoint : Target;
+		}
+	});
+}
+
+void UNeuroStrikeSwarmProjectileSubsystem::ResolveHits() {
+	UNeuroStrikeDamageSubsystem* Damage = this->GetWorld()->GetSubsystem<UNeuroStrikeDamageSubsystem>();
+
+	// Iterating backwards keeps the indices still to visit valid while hit projectiles are swapped out.
+	for (int32 Index = this->Positions.Num() - 1; Index >= 0; --Index) {
+		const FHitResult& Hit = this->SweepHits[Index];
+		if (Hit.bBlockingHit) {
+			if (Damage != nullptr && !this->CosmeticFlags[Index]) {
+				if (ANeuroStrikeCharacter* HitCharacter = Cast<ANeuroStrikeCharacter>(Hit.GetActor())) {
+					Damage->QueueDamage(this->Instigators[Index].Get(), HitCharacter, this->Damages[Index],
+					                    Hit.ImpactPoint);
+				}
+			}
+			this->RemoveProjectileAtSwap(Index);
+		} else if (this->Lifetimes[Index] <= 0.0f) {
+			this->RemoveProjectileAtSwap(Index);
+		}
+	}
+
+	this->SweepHits.Reset();
+}
+
+void UNeuroStrikeSwarmProjectileSubsystem::RemoveProjectileAtSwap(int32 Index) {
+	this->Positions.RemoveAtSwap(Index, 1, false);
+	this->Velocities.RemoveAtSwap(Index, 1, false);
+	this->Lifetimes.RemoveAtSwap(Index, 1, false);
+	this->Damages.RemoveAtSwap(Index, 1, false);
+	this->Instigators.RemoveAtSwap(Index, 1, false);
+	this->CosmeticFlags.RemoveAtSwap(Index);
+
+	DEC_DWORD_STAT(STAT_NeuroStrike_SwarmProjectiles);
+}
+
+void UNeuroStrikeSwarmProjectileSubsystem::CreateRenderComponent() {
+	this->bRenderInitialized = true;
+
+	UWorld* World = this->GetWorld();
+	if (!UNeuroStrikePreloadSubsystem::ShouldLoadCosmetics(World) || this->ProjectileMesh.IsNull()) {
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	this->RenderActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+	if (this->RenderActor == nullptr) {
+		return;
+	}
+
+	this->RenderComponent = NewObject<UInstancedStaticMeshComponent>(this->RenderActor, TEXT("SwarmInstances"));
+	this->RenderComponent->SetMobility(EComponentMobility::Movable);
+	this->RenderComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	this->RenderComponent->SetCanEverAffectNavigation(false);
+	this->RenderComponent->SetCastShadow(false);
+	this->RenderActor->SetRootComponent(this->RenderComponent);
+	this->RenderComponent->RegisterComponent();
+
+	if (UNeuroStrikePreloadSubsystem* Preload = World->GetSubsystem<UNeuroStrikePreloadSubsystem>()) {
+		Preload->RequestAsyncLoad({this->ProjectileMesh.ToSoftObjectPath()}, true,
+		                          FStreamableDelegate::CreateUObject(
+			                          this, &UNeuroStrikeSwarmProjectileSubsystem::OnProjectileMeshLoaded));
+	}
+}
+
+void UNeuroStrikeSwarmProjectileSubsystem::OnProjectileMeshLoaded() {
+	if (this->RenderComponent != nullptr) {
+		this->RenderComponent->SetStaticMesh(this->ProjectileMesh.Get());
+	}
+}
+
+void UNeuroStrikeSwarmProjectileSubsystem::UpdateRenderInstances() {
+	if (this->RenderComponent == nullptr) {
+		return;
+	}
+
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Swarm Render Update", STAT_NeuroStrike_SwarmRender);
+
+	const int32 NumProjectiles = this->Positions.Num();
+	const int32 NumInstances = this->RenderComponent->GetInstanceCount();
+	if (NumProjectiles == 0 && this->NumRenderedProjectiles == 0) {
+		return;
+	}
+
+	// Instances are only ever added; the ones above the projectile count are collapsed instead of removed.
+	// Only instances that are live, or were live last frame and just need collapsing, are written.
+	const int32 NumWritten = FMath::Max(NumProjectiles, this->NumRenderedProjectiles);
+	this->InstanceTransforms.SetNum(NumWritten, false);
+	const FVector Scale(this->ProjectileMeshScale);
+	for (int32 Index = 0; Index < this->InstanceTransforms.Num(); ++Index) {
+		this->InstanceTransforms[Index] = Index < NumProjectiles
+			                                  ? FTransform(this->Velocities[Index].Rotation(), this->Positions[Index],
+			                                               Scale)
+			                                  : FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+	}
+
+	if (NumProjectiles > NumInstances) {
+		this->RenderComponent->AddInstances(
+			TArray<FTransform>(this->InstanceTransforms.GetData() + NumInstances, NumProjectiles - NumInstances),
+			false, true);
+	}
+
+	// Instances added above already hold their transforms.
+	const int32 NumUpdated = FMath::Min(NumWritten, NumInstances);
+	if (NumUpdated > 0) {
+		this->InstanceTransforms.SetNum(NumUpdated, false);
+		this->RenderComponent->BatchUpdateInstancesTransforms(0, this->InstanceTransforms, true, true, true);
+	}
+
+	this->NumRenderedProjectiles = NumProjectiles;
+}
@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikeSwarmProjectileSubsystem.generated.h"
+
+class ANeuroStrikeCharacter;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Subsystem that simulates large numbers of lightweight projectiles without an actor per projectile.
+ *
+ * Projectiles are stored as parallel arrays of positions, velocities, lifetimes, damage and instigators. Every
+ * frame they are integrated and swept against the scene in chunks on the task graph; only the hits found by the
+ * sweep come back to the game thread, where they are queued as damage events for UNeuroStrikeDamageSubsystem.
+ *
+ * Nothing is replicated. The server simulates the projectiles that deal damage while clients simulate cosmetic
+ * copies of the same shots, and every machine that renders draws all of its projectiles with one instanced
+ * static mesh.
+ */
+UCLASS(config=Game)
+class NEUROSTRIKE_API UNeuroStrikeSwarmProjectileSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/**
+	 * Integrates, sweeps and resolves every projectile, then updates the rendered instances.
+	 *
+	 * @param DeltaTime Time elapsed since the previous frame.
+	 */
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Adds a projectile to the simulation.
+	 *
+	 * @param Instigator The character that fired the projectile. Ignored by its sweep and credited for the damage.
+	 * @param Location World location the projectile starts from.
+	 * @param Velocity Initial velocity of the projectile, in units per second.
+	 * @param Lifetime Seconds after which the projectile expires if it has not hit anything.
+	 * @param Damage Damage applied to the first character hit. Cosmetic projectiles never apply damage.
+	 * @param bCosmetic Whether the projectile is only simulated for display.
+	 * @return Whether the projectile was added; fails when MaxProjectiles are already in flight.
+	 */
+	bool SpawnProjectile(ANeuroStrikeCharacter* Instigator, const FVector& Location, const FVector& Velocity,
+	                     float Lifetime, float Damage, bool bCosmetic);
+
+	/** @return The number of projectiles in flight. */
+	int32 GetNumProjectiles() const { return this->Positions.Num(); }
+
+	/** Maximum number of projectiles in flight at once. */
+	UPROPERTY(config)
+	int32 MaxProjectiles = 8192;
+
+	/** Number of projectiles integrated and swept by a single task. */
+	UPROPERTY(config)
+	int32 ProjectilesPerTask = 256;
+
+	/** Collision channel projectiles are swept against. */
+	UPROPERTY(config)
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	/** Scale of the world gravity applied to projectiles. */
+	UPROPERTY(config)
+	float GravityScale = 0.0f;
+
+	/** Mesh drawn for every projectile. */
+	UPROPERTY(config)
+	TSoftObjectPtr<UStaticMesh> ProjectileMesh;
+
+	/** Uniform scale of the drawn mesh. */
+	UPROPERTY(config)
+	float ProjectileMeshScale = 0.05f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/**
+	 * Integrates every projectile and sweeps the segment it travelled this frame, in parallel.
+	 *
+	 * @param DeltaTime Time elapsed since the previous frame.
+	 */
+	void Simulate(float DeltaTime);
+
+	/** Applies the hits found by Simulate and removes hit or expired projectiles. */
+	void ResolveHits();
+
+	/**
+	 * Removes a projectile without preserving order.
+	 *
+	 * @param Index Index of the projectile in the simulation arrays.
+	 */
+	void RemoveProjectileAtSwap(int32 Index);
+
+	/** Creates the instanced mesh used to draw projectiles, if this world renders. */
+	void CreateRenderComponent();
+
+	/** Writes the current projectile positions into the rendered instances. */
+	void UpdateRenderInstances();
+
+	/** Assigns the streamed projectile mesh to the rendered instances. */
+	void OnProjectileMeshLoaded();
+
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> Lifetimes;
+	TArray<float> Damages;
+	TArray<TWeakObjectPtr<ANeuroStrikeCharacter>> Instigators;
+	TBitArray<> CosmeticFlags;
+
+	/** Result of the latest sweep of every projectile; only valid between Simulate and ResolveHits. */
+	TArray<FHitResult> SweepHits;
+
+	/** Instigator of every projectile, resolved on the game thread for the sweep tasks. */
+	TArray<const AActor*> IgnoredActors;
+
+	/** Instance transforms written every frame; reused to avoid reallocating. */
+	TArray<FTransform> InstanceTransforms;
+
+	/** Number of live projectiles drawn by the previous render update; instances above it are collapsed. */
+	int32 NumRenderedProjectiles = 0;
+
+	/** Actor owning the rendered instances. */
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> RenderActor;
+
+	/** Instanced mesh drawing every projectile. */
+	UPROPERTY(Transient)
+	TObjectPtr<UInstancedStaticMeshComponent> RenderComponent;
+
+	/** Whether CreateRenderComponent already ran. */
+	bool bRenderInitialized = false;
+};
@@ -0,0 +1,106 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeTombField.h"
+#include "NeuroStrikePreloadSubsystem.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Net/UnrealNetwork.h"
+
+ANeuroStrikeTombField::ANeuroStrikeTombField() {
+	this->PrimaryActorTick.bCanEverTick = false;
+
+	this->InstancedMesh = this->CreateDefaultSubobject<UInstancedStaticMeshComponent>("InstancedMesh");
+	this->InstancedMesh->SetMobility(EComponentMobility::Static);
+	this->InstancedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	this->InstancedMesh->SetCanEverAffectNavigation(false);
+	this->RootComponent = this->InstancedMesh;
+
+	this->bReplicates = true;
+	// Tombs span the whole map, so the field is relevant everywhere and only wakes up when a tomb is added.
+	this->bAlwaysRelevant = true;
+	this->NetDormancy = DORM_DormantAll;
+	this->SetReplicatingMovement(false);
+}
+
+void ANeuroStrikeTombField::SetTombMesh(const TSoftObjectPtr<UStaticMesh>& Mesh) {
+	this->FlushNetDormancy();
+	this->TombMesh = Mesh;
+	this->OnRep_TombMesh();
+}
+
+void ANeuroStrikeTombField::AddTomb(const FTransform& Transform) {
+	if (!this->HasAuthority()) {
+		return;
+	}
+
+	FNeuroStrikeTomb Tomb;
+	Tomb.Location = Transform.GetLocation();
+	Tomb.Yaw = FRotator::NormalizeAxis(Transform.Rotator().Yaw);
+
+	this->FlushNetDormancy();
+
+	if (this->Tombs.Num() < this->MaxTombs) {
+		this->Tombs.Add(Tomb);
+	} else {
+		this->Tombs[this->NextRecycledIndex] = Tomb;
+		this->NextRecycledIndex = (this->NextRecycledIndex + 1) % this->MaxTombs;
+	}
+
+	this->SyncInstances();
+}
+
+void ANeuroStrikeTombField::OnRep_TombMesh() {
+	if (UNeuroStrikePreloadSubsystem* Preload = GetWorld()->GetSubsystem<UNeuroStrikePreloadSubsystem>()) {
+		Preload->RequestAsyncLoad({this->TombMesh.ToSoftObjectPath()}, true,
+		                          FStreamableDelegate::CreateUObject(this, &ANeuroStrikeTombField::OnTombMeshLoaded));
+	}
+}
+
+void ANeuroStrikeTombField::OnTombMeshLoaded() {
+	this->InstancedMesh->SetStaticMesh(this->TombMesh.Get());
+}
+
+void ANeuroStrikeTombField::OnRep_Tombs() {
+	this->SyncInstances();
+}
+
+void ANeuroStrikeTombField::SyncInstances() {
+	const int32 NumTombs = this->Tombs.Num();
+	const int32 NumApplied = this->AppliedTombs.Num();
+
+	for (int32 Index = 0; Index < FMath::Min(NumTombs, NumApplied); ++Index) {
+		const FNeuroStrikeTomb& Tomb = this->Tombs[Index];
+		if (Tomb == this->AppliedTombs[Index]) {
+			continue;
+		}
+
+		this->InstancedMesh->UpdateInstanceTransform(
+			Index, FTransform(FRotator(0.0f, Tomb.Yaw, 0.0f), Tomb.Location), true, false, true);
+	}
+
+	if (NumTombs > NumApplied) {
+		TArray<FTransform> NewInstances;
+		NewInstances.Reserve(NumTombs - NumApplied);
+		for (int32 Index = NumApplied; Index < NumTombs; ++Index) {
+			const FNeuroStrikeTomb& Tomb = this->Tombs[Index];
+			NewInstances.Emplace(FRotator(0.0f, Tomb.Yaw, 0.0f), Tomb.Location);
+		}
+		this->InstancedMesh->AddInstances(NewInstances, false, true);
+	} else if (NumTombs < NumApplied) {
+		TArray<int32> RemovedInstances;
+		for (int32 Index = NumApplied - 1; Index >= NumTombs; --Index) {
+			RemovedInstances.Add(Index);
+		}
+		this->InstancedMesh->RemoveInstances(RemovedInstances);
+	}
+
+	this->InstancedMesh->MarkRenderStateDirty();
+	this->AppliedTombs = this->Tombs;
+}
+
+void ANeuroStrikeTombField::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const {
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ANeuroStrikeTombField, TombMesh);
+	DOREPLIFETIME(ANeuroStrikeTombField, Tombs);
+}
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
+#include "NeuroStrikeTombField.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/** Replicated placement of a single tomb. */
+USTRUCT()
+struct FNeuroStrikeTomb {
+	GENERATED_BODY()
+
+	/** World location of the tomb, rounded to whole units. */
+	UPROPERTY()
+	FVector_NetQuantize Location = FVector::ZeroVector;
+
+	/** Yaw of the tomb in degrees. */
+	UPROPERTY()
+	float Yaw = 0.0f;
+
+	bool operator==(const FNeuroStrikeTomb& Other) const {
+		return this->Location == Other.Location && this->Yaw == Other.Yaw;
+	}
+};
+
+/**
+ * Static, dormant actor that renders every tomb of one mesh as instances of a single component.
+ *
+ * Replaces spawning one movable AStaticMeshActor per death on every machine. The server appends tombs to a
+ * replicated list, flushing dormancy only for that one update, and clients mirror the list into an instanced
+ * static mesh component, so the whole graveyard costs one draw and one mostly dormant network actor however
+ * long the match runs. Once MaxTombs is reached the oldest tomb is recycled.
+ */
+UCLASS()
+class NEUROSTRIKE_API ANeuroStrikeTombField : public AActor {
+	GENERATED_BODY()
+
+public:
+	ANeuroStrikeTombField();
+
+	/**
+	 * Sets the mesh drawn for every tomb of this field. Only called once by the server after spawning.
+	 *
+	 * @param Mesh The tomb mesh. Streamed in asynchronously wherever tombs are rendered.
+	 */
+	void SetTombMesh(const TSoftObjectPtr<UStaticMesh>& Mesh);
+
+	/**
+	 * Adds a tomb to the field and replicates it to every client. Authority only.
+	 *
+	 * @param Transform The transform of the dead character. Only its location and yaw are kept.
+	 */
+	void AddTomb(const FTransform& Transform);
+
+	/**
+	 * Retrieves the number of tombs currently in the field.
+	 *
+	 * @return The number of tombs.
+	 */
+	int32 GetNumTombs() const {
+		return this->Tombs.Num();
+	}
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Maximum number of tombs kept in the field before the oldest ones are reused. */
+	UPROPERTY(EditDefaultsOnly, Category=Tomb, meta=(ClampMin="1"))
+	int32 MaxTombs = 256;
+
+private:
+	/** Streams in the replicated mesh on clients. */
+	UFUNCTION()
+	void OnRep_TombMesh();
+
+	/** Applies the mesh once it has been streamed in. */
+	void OnTombMeshLoaded();
+
+	/** Mirrors the replicated tomb list into the instanced mesh on clients. */
+	UFUNCTION()
+	void OnRep_Tombs();
+
+	/**
+	 * Brings the instances of the mesh component in line with the tomb list, touching only changed entries.
+	 */
+	void SyncInstances();
+
+	/** Instanced mesh rendering every tomb of this field. */
+	UPROPERTY(VisibleDefaultsOnly, Category=Tomb)
+	TObjectPtr<UInstancedStaticMeshComponent> InstancedMesh;
+
+	/** Mesh drawn for every tomb. Replicated as a path, so the server never has to load it. */
+	UPROPERTY(ReplicatedUsing=OnRep_TombMesh)
+	TSoftObjectPtr<UStaticMesh> TombMesh;
+
+	/** Every tomb of the field, in insertion order until MaxTombs is reached. */
+	UPROPERTY(ReplicatedUsing=OnRep_Tombs)
+	TArray<FNeuroStrikeTomb> Tombs;
+
+	/** Tombs reflected by the mesh instances, used to update only what changed. */
+	TArray<FNeuroStrikeTomb> AppliedTombs;
+
+	/** Index of the next tomb to overwrite once the field is full. */
+	int32 NextRecycledIndex = 0;
+};
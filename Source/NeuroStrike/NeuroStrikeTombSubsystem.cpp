@@ -0,0 +1,38 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeTombSubsystem.h"
+#include "NeuroStrikeTombField.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+
+void UNeuroStrikeTombSubsystem::AddTomb(const TSoftObjectPtr<UStaticMesh>& Mesh, const FTransform& Transform) {
+	UWorld* World = this->GetWorld();
+	if (Mesh.IsNull() || World == nullptr || World->GetNetMode() == NM_Client) {
+		return;
+	}
+
+	TObjectPtr<ANeuroStrikeTombField>& Field = this->Fields.FindOrAdd(Mesh.ToSoftObjectPath());
+	if (!IsValid(Field)) {
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Field = World->SpawnActor<ANeuroStrikeTombField>(ANeuroStrikeTombField::StaticClass(), FTransform::Identity,
+		                                                 SpawnParameters);
+		if (Field == nullptr) {
+			return;
+		}
+
+		Field->SetTombMesh(Mesh);
+	}
+
+	Field->AddTomb(Transform);
+}
+
+void UNeuroStrikeTombSubsystem::Deinitialize() {
+	this->Fields.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UNeuroStrikeTombSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NeuroStrikeTombSubsystem.generated.h"
+
+class ANeuroStrikeTombField;
+class UStaticMesh;
+
+/**
+ * Server-side world subsystem that places tombs for dead characters.
+ *
+ * Keeps one ANeuroStrikeTombField per tomb mesh, so every tomb sharing a mesh is drawn by the same instanced
+ * component and replicated through the same dormant actor.
+ */
+UCLASS()
+class NEUROSTRIKE_API UNeuroStrikeTombSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Places a tomb. Does nothing without authority; clients receive tombs through the tomb fields.
+	 *
+	 * @param Mesh The tomb mesh. Only referenced, the server does not need it loaded.
+	 * @param Transform The transform of the dead character.
+	 */
+	void AddTomb(const TSoftObjectPtr<UStaticMesh>& Mesh, const FTransform& Transform);
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Tomb fields keyed by the mesh they draw. */
+	UPROPERTY()
+	TMap<FSoftObjectPath, TObjectPtr<ANeuroStrikeTombField>> Fields;
+};
@@ -0,0 +1,61 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeTransformHistory.h"
+
+void FNeuroStrikeTransformHistory::Init(int32 Capacity) {
+	this->Samples.SetNumUninitialized(FMath::Max(Capacity, 1));
+	this->Reset();
+}
+
+void FNeuroStrikeTransformHistory::Reset() {
+	this->Head = 0;
+	this->Count = 0;
+}
+
+void FNeuroStrikeTransformHistory::Record(float Time, const FVector& Location, const FQuat& Rotation) {
+	if (this->Samples.Num() == 0) {
+		return;
+	}
+
+	FNeuroStrikeTransformSample& Sample = this->Samples[this->Head];
+	Sample.Time = Time;
+	Sample.Location = Location;
+	Sample.Rotation = Rotation;
+
+	this->Head = (this->Head + 1) % this->Samples.Num();
+	this->Count = FMath::Min(this->Count + 1, this->Samples.Num());
+}
+
+bool FNeuroStrikeTransformHistory::Sample(float Time, FVector& OutLocation, FQuat& OutRotation) const {
+	if (this->Count == 0) {
+		return false;
+	}
+
+	const FNeuroStrikeTransformSample* Newer = &this->GetByAge(0);
+	if (Time >= Newer->Time) {
+		OutLocation = Newer->Location;
+		OutRotation = Newer->Rotation;
+		return true;
+	}
+
+	for (int32 Age = 1; Age < this->Count; ++Age) {
+		const FNeuroStrikeTransformSample& Older = this->GetByAge(Age);
+		if (Time >= Older.Time) {
+			const float Span = Newer->Time - Older.Time;
+			const float Alpha = Span > UE_KINDA_SMALL_NUMBER ? (Time - Older.Time) / Span : 1.0f;
+			OutLocation = FMath::Lerp(Older.Location, Newer->Location, Alpha);
+			OutRotation = FQuat::Slerp(Older.Rotation, Newer->Rotation, Alpha);
+			return true;
+		}
+		Newer = &Older;
+	}
+
+	OutLocation = Newer->Location;
+	OutRotation = Newer->Rotation;
+	return true;
+}
+
+const FNeuroStrikeTransformSample& FNeuroStrikeTransformHistory::GetByAge(int32 Age) const {
+	const int32 Capacity = this->Samples.Num();
+	return this->Samples[(this->Head - 1 - Age + Capacity) % Capacity];
+}
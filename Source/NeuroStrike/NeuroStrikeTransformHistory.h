@@ -0,0 +1,85 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * A single recorded transform of a character's collision capsule.
+ */
+struct FNeuroStrikeTransformSample {
+	/** Server world time the sample was taken at. */
+	float Time;
+
+	/** World location of the capsule. */
+	FVector Location;
+
+	/** World rotation of the capsule. */
+	FQuat Rotation;
+};
+
+/**
+ * Fixed-size ring buffer of capsule transforms used for server-side lag compensation.
+ *
+ * The storage is allocated once by Init and reused afterwards, so recording never allocates. Samples are
+ * stored contiguously and looked up newest to oldest, which is the order rewinds access them in.
+ */
+class NEUROSTRIKE_API FNeuroStrikeTransformHistory {
+public:
+	/**
+	 * Allocates storage for the given number of samples and clears the history.
+	 *
+	 * @param Capacity The maximum number of samples kept before the oldest one is overwritten.
+	 */
+	void Init(int32 Capacity);
+
+	/** Forgets every recorded sample while keeping the storage. */
+	void Reset();
+
+	/**
+	 * Records a new sample, overwriting the oldest one once the buffer is full.
+	 *
+	 * @param Time Server world time of the sample. Must not be older than the previous sample.
+	 * @param Location World location of the capsule.
+	 * @param Rotation World rotation of the capsule.
+	 */
+	void Record(float Time, const FVector& Location, const FQuat& Rotation);
+
+	/**
+	 * Reconstructs the capsule transform at the given time by interpolating between the surrounding samples.
+	 * Times older than the oldest sample are clamped to it, times newer than the newest sample to that one.
+	 *
+	 * @param Time Server world time to reconstruct.
+	 * @param OutLocation Receives the reconstructed location.
+	 * @param OutRotation Receives the reconstructed rotation.
+	 * @return false if no sample has been recorded yet.
+	 */
+	bool Sample(float Time, FVector& OutLocation, FQuat& OutRotation) const;
+
+	/**
+	 * Retrieves the number of samples currently stored.
+	 *
+	 * @return The number of valid samples, at most the capacity passed to Init.
+	 */
+	int32 Num() const {
+		return this->Count;
+	}
+
+private:
+	/**
+	 * Retrieves a sample by age.
+	 *
+	 * @param Age 0 for the newest sample, Num() - 1 for the oldest.
+	 * @return The sample of the given age.
+	 */
+	const FNeuroStrikeTransformSample& GetByAge(int32 Age) const;
+
+	/** Preallocated sample storage. */
+	TArray<FNeuroStrikeTransformSample> Samples;
+
+	/** Index the next sample is written to. */
+	int32 Head = 0;
+
+	/** Number of valid samples. */
+	int32 Count = 0;
+};
@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NeuroStrikeWeaponDefinition.h"
+#include "NeuroStrikeProjectile.h"
+
+FNeuroStrikeWeaponStats::FNeuroStrikeWeaponStats() {
+	for (float& Sample : this->DamageFalloff) {
+		Sample = 1.0f;
+	}
+}
+
+const FNeuroStrikeWeaponStats& FNeuroStrikeWeaponStats::GetDefault() {
+	static const FNeuroStrikeWeaponStats Default;
+	return Default;
+}
+
+float FNeuroStrikeWeaponStats::GetFalloff(float Distance) const {
+	const float Position = FMath::Clamp(Distance / this->FalloffRange, 0.0f, 1.0f) * (NumFalloffSamples - 1);
+	const int32 Index = FMath::Min(static_cast<int32>(Position), NumFalloffSamples - 2);
+	return FMath::Lerp(this->DamageFalloff[Index], this->DamageFalloff[Index + 1], Position - Index);
+}
+
+void UNeuroStrikeWeaponDefinition::PostLoad() {
+	Super::PostLoad();
+
+	this->BakeStats();
+}
+
+#if WITH_EDITOR
+void UNeuroStrikeWeaponDefinition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) {
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Weapons that already hold the previous stats keep them until they are attached again.
+	this->BakeStats();
+}
+#endif
+
+TSharedRef<const FNeuroStrikeWeaponStats> UNeuroStrikeWeaponDefinition::GetStats() const {
+	if (!this->Stats.IsValid()) {
+		this->BakeStats();
+	}
+
+	return this->Stats.ToSharedRef();
+}
+
+void UNeuroStrikeWeaponDefinition::BakeStats() const {
+	TSharedRef<FNeuroStrikeWeaponStats> Baked = MakeShared<FNeuroStrikeWeaponStats>();
+	Baked->ShotType = this->ShotType;
+	Baked->FireMode = this->FireMode;
+	Baked->TraceChannel = this->TraceChannel;
+	Baked->BurstCount = FMath::Max(this->BurstCount, 1);
+	Baked->PelletCount = FMath::Max(this->PelletCount, 1);
+	Baked->ShotInterval = 60.0f / FMath::Max(this->RoundsPerMinute, 1.0f);
+	Baked->SpreadHalfAngle = FMath::DegreesToRadians(this->SpreadAngle);
+	Baked->MinDamage = FMath::Min(this->MinDamage, this->MaxDamage);
+	Baked->MaxDamage = FMath::Max(this->MinDamage, this->MaxDamage);
+	Baked->ProjectileSpeed = this->ProjectileSpeed;
+	Baked->ProjectileLifetime = this->ProjectileLifetime;
+	Baked->bProjectileBounces = this->bProjectileBounces;
+	Baked->Range = this->HitscanRange;
+	Baked->FalloffRange = FMath::Max(this->FalloffRange, 1.0f);
+	Baked->MuzzleOffset = this->MuzzleOffset;
+	Baked->ProjectileClass = this->ProjectileClass;
+
+	const FRichCurve* Curve = this->DamageFalloff.GetRichCurveConst();
+	if (Curve != nullptr && Curve->GetNumKeys() > 0) {
+		for (int32 Index = 0; Index < FNeuroStrikeWeaponStats::NumFalloffSamples; ++Index) {
+			const float Distance = Baked->FalloffRange * Index / (FNeuroStrikeWeaponStats::NumFalloffSamples - 1);
+			Baked->DamageFalloff[Index] = FMath::Max(Curve->Eval(Distance), 0.0f);
+		}
+	}
+
+	this->Stats = Baked;
+}
@@ -0,0 +1,227 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/DataAsset.h"
+#include "Engine/EngineTypes.h"
+#include "NeuroStrikeWeaponDefinition.generated.h"
+
+class ANeuroStrikeProjectile;
+
+/** How a weapon resolves the shots it fires. */
+UENUM(BlueprintType)
+enum class ENeuroStrikeShotType : uint8 {
+	/** Launches a simulated projectile actor that travels and collides. */
+	Projectile,
+
+	/** Resolves the shot instantly with a line trace, batched on the server. */
+	Hitscan,
+
+	/** Fires a spread of lightweight pellets simulated in bulk, without an actor per pellet. */
+	Swarm
+};
+
+/** How a weapon turns trigger presses into shots. */
+UENUM(BlueprintType)
+enum class ENeuroStrikeFireMode : uint8 {
+	/** Fires a single shot per trigger press. */
+	Semi,
+
+	/** Fires BurstCount shots per trigger press, even if the trigger is released early. */
+	Burst,
+
+	/** Fires continuously while the trigger is held. */
+	Auto
+};
+
+/**
+ * Flat, immutable snapshot of everything the fire and damage paths need to know about a weapon.
+ *
+ * Baked once from a weapon definition, or from the legacy properties of a weapon component, and then shared
+ * read-only by the weapon and the projectiles it fires. Derived values such as the shot interval and the spread
+ * in radians are precomputed, and the damage falloff curve is sampled into a small fixed table, so a shot only
+ * reads a few adjacent fields and never evaluates a curve or touches a UObject property.
+ */
+struct NEUROSTRIKE_API FNeuroStrikeWeaponStats {
+	/** Number of samples of the damage falloff table. */
+	static constexpr int32 NumFalloffSamples = 16;
+
+	ENeuroStrikeShotType ShotType = ENeuroStrikeShotType::Projectile;
+	ENeuroStrikeFireMode FireMode = ENeuroStrikeFireMode::Semi;
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	/** Shots fired per trigger press in burst mode. */
+	int32 BurstCount = 3;
+
+	/** Pellets spawned by a single swarm shot. Hitscan and projectile shots always fire one. */
+	int32 PelletCount = 1;
+
+	/** Seconds between two shots. */
+	float ShotInterval = 0.1f;
+
+	/** Half-angle of the cone swarm pellets are spread over, in radians. */
+	float SpreadHalfAngle = 0.0f;
+
+	/** Damage range rolled per hit, before falloff. */
+	float MinDamage = 10.0f;
+	float MaxDamage = 20.0f;
+
+	/** Speed of projectiles and pellets, in units per second. Zero keeps the projectile class default. */
+	float ProjectileSpeed = 0.0f;
+
+	/** Seconds after which projectiles and pellets expire. Zero keeps the projectile class default. */
+	float ProjectileLifetime = 0.0f;
+
+	/** Whether projectiles bounce off geometry until they hit a character or expire, instead of stopping. */
+	bool bProjectileBounces = false;
+
+	/** Maximum distance of hitscan traces. */
+	float Range = 10000.0f;
+
+	/** Distance covered by the falloff table; hits beyond it use the last sample. */
+	float FalloffRange = 10000.0f;
+
+	/** Offset of the muzzle from the owning character's eyes, in aim space. */
+	FVector MuzzleOffset = FVector(100.0f, 0.0f, 10.0f);
+
+	/** Projectile actor launched by projectile weapons. */
+	TSubclassOf<ANeuroStrikeProjectile> ProjectileClass;
+
+	/** Damage multiplier sampled at regular distances from 0 to FalloffRange. */
+	float DamageFalloff[NumFalloffSamples];
+
+	FNeuroStrikeWeaponStats();
+
+	/**
+	 * Retrieves the stats of a weapon without a definition nor overrides: 10 to 20 damage without falloff.
+	 *
+	 * @return A shared default-constructed instance.
+	 */
+	static const FNeuroStrikeWeaponStats& GetDefault();
+
+	/**
+	 * Rolls the damage of a hit before falloff.
+	 *
+	 * @param Alpha Random value in [0, 1] picking the damage between MinDamage and MaxDamage.
+	 * @return The rolled damage.
+	 */
+	float RollDamage(float Alpha) const {
+		return FMath::Lerp(this->MinDamage, this->MaxDamage, Alpha);
+	}
+
+	/**
+	 * Looks up the damage multiplier of a hit at the given distance.
+	 *
+	 * @param Distance Distance between the muzzle and the hit.
+	 * @return The multiplier interpolated from the falloff table.
+	 */
+	float GetFalloff(float Distance) const;
+};
+
+/**
+ * Data asset describing a weapon: how it fires, what it fires and how much damage its hits deal.
+ *
+ * Weapons are added by creating new definitions instead of new C++. The definition is baked into an
+ * FNeuroStrikeWeaponStats when it is loaded and whenever it is edited; weapon components only ever read the
+ * baked stats.
+ */
+UCLASS(BlueprintType)
+class NEUROSTRIKE_API UNeuroStrikeWeaponDefinition : public UPrimaryDataAsset {
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/**
+	 * Retrieves the baked stats of the weapon, baking them first if the definition was created at runtime.
+	 *
+	 * @return The immutable stats shared by every weapon using this definition.
+	 */
+	TSharedRef<const FNeuroStrikeWeaponStats> GetStats() const;
+
+	/** Whether shots are simulated projectiles, instant hitscan traces or swarms of lightweight pellets */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	ENeuroStrikeShotType ShotType = ENeuroStrikeShotType::Projectile;
+
+	/** How trigger presses are turned into shots */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	ENeuroStrikeFireMode FireMode = ENeuroStrikeFireMode::Semi;
+
+	/** Maximum cadence of the weapon, in rounds per minute */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon, meta=(ClampMin="1"))
+	float RoundsPerMinute = 600.0f;
+
+	/** Number of shots fired per trigger press in burst mode */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon,
+		meta=(ClampMin="1", EditCondition="FireMode == ENeuroStrikeFireMode::Burst"))
+	int32 BurstCount = 3;
+
+	/** Offset of the muzzle from the owning character's eyes, in aim space */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	FVector MuzzleOffset = FVector(100.0f, 0.0f, 10.0f);
+
+	/** Projectile actor launched by projectile weapons */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile,
+		meta=(EditCondition="ShotType == ENeuroStrikeShotType::Projectile"))
+	TSubclassOf<ANeuroStrikeProjectile> ProjectileClass;
+
+	/** Speed of projectiles and pellets, in units per second. Zero keeps the projectile class default */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(ClampMin="0"))
+	float ProjectileSpeed = 3000.0f;
+
+	/** Seconds after which projectiles and pellets expire. Zero keeps the projectile class default */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(ClampMin="0"))
+	float ProjectileLifetime = 3.0f;
+
+	/** Whether projectiles bounce off geometry until they hit a character or expire, instead of stopping */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile,
+		meta=(EditCondition="ShotType == ENeuroStrikeShotType::Projectile"))
+	bool bProjectileBounces = false;
+
+	/** Maximum distance a hitscan shot travels from the muzzle */
+	UPROPERTY(EditDefaultsOnly, Category=Hitscan, meta=(EditCondition="ShotType == ENeuroStrikeShotType::Hitscan"))
+	float HitscanRange = 10000.0f;
+
+	/** Collision channel hitscan shots and pellets are traced against */
+	UPROPERTY(EditDefaultsOnly, Category=Hitscan)
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	/** Number of pellets fired by a single swarm shot */
+	UPROPERTY(EditDefaultsOnly, Category=Spread,
+		meta=(ClampMin="1", EditCondition="ShotType == ENeuroStrikeShotType::Swarm"))
+	int32 PelletCount = 1;
+
+	/** Half-angle in degrees of the cone swarm pellets are spread over */
+	UPROPERTY(EditDefaultsOnly, Category=Spread,
+		meta=(ClampMin="0", EditCondition="ShotType == ENeuroStrikeShotType::Swarm"))
+	float SpreadAngle = 0.0f;
+
+	/** Lowest damage of a hit before falloff */
+	UPROPERTY(EditDefaultsOnly, Category=Damage, meta=(ClampMin="0"))
+	float MinDamage = 10.0f;
+
+	/** Highest damage of a hit before falloff */
+	UPROPERTY(EditDefaultsOnly, Category=Damage, meta=(ClampMin="0"))
+	float MaxDamage = 20.0f;
+
+	/** Damage multiplier by distance from the muzzle, in units. An empty curve means no falloff */
+	UPROPERTY(EditDefaultsOnly, Category=Damage)
+	FRuntimeFloatCurve DamageFalloff;
+
+	/** Distance over which DamageFalloff is sampled; hits beyond it use the value at this distance */
+	UPROPERTY(EditDefaultsOnly, Category=Damage, meta=(ClampMin="1"))
+	float FalloffRange = 10000.0f;
+
+private:
+	/** Bakes the current properties into Stats. */
+	void BakeStats() const;
+
+	/** Stats baked from the current properties. */
+	mutable TSharedPtr<const FNeuroStrikeWeaponStats> Stats;
+};
@@ -1,24 +1,43 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "TP_PickUpComponent.h"
+#include "NeuroStrikePickupSubsystem.h"
 
 UTP_PickUpComponent::UTP_PickUpComponent() {
 	SphereRadius = 32.f;
+
+	// Contacts are found by the pickup subsystem; the sphere only provides location and radius.
+	this->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	this->SetGenerateOverlapEvents(false);
+	this->SetCanEverAffectNavigation(false);
 }
 
 void UTP_PickUpComponent::BeginPlay() {
 	Super::BeginPlay();
 
-	this->OnComponentBeginOverlap.AddDynamic(this, &UTP_PickUpComponent::OnSphereBeginOverlap);
+	if (UNeuroStrikePickupSubsystem* Pickups = GetWorld()->GetSubsystem<UNeuroStrikePickupSubsystem>()) {
+		Pickups->RegisterPickup(this);
+	}
+}
+
+void UTP_PickUpComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (UWorld* World = GetWorld()) {
+		if (UNeuroStrikePickupSubsystem* Pickups = World->GetSubsystem<UNeuroStrikePickupSubsystem>()) {
+			Pickups->UnregisterPickup(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void UTP_PickUpComponent::OnSphereBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-                                               UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep,
-                                               const FHitResult& SweepResult) {
-	ANeuroStrikeCharacter* Character = Cast<ANeuroStrikeCharacter>(OtherActor);
-	if (Character != nullptr) {
-		this->OnPickUp.Broadcast(Character);
+void UTP_PickUpComponent::NotifyPickedUp(ANeuroStrikeCharacter* Character) {
+	if (Character == nullptr) {
+		return;
+	}
 
-		this->OnComponentBeginOverlap.RemoveAll(this);
+	if (UNeuroStrikePickupSubsystem* Pickups = GetWorld()->GetSubsystem<UNeuroStrikePickupSubsystem>()) {
+		Pickups->UnregisterPickup(this);
 	}
+
+	this->OnPickUp.Broadcast(Character);
 }
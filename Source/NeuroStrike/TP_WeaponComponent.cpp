@@ -1,15 +1,62 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "TP_WeaponComponent.h"
+#include "NeuroStrike.h"
 #include "NeuroStrikeCharacter.h"
+#include "NeuroStrikeHitscanSubsystem.h"
+#include "NeuroStrikeLatencySubsystem.h"
 #include "NeuroStrikeProjectile.h"
-#include "GameFramework/PlayerController.h"
-#include "Camera/PlayerCameraManager.h"
+#include "NeuroStrikePreloadSubsystem.h"
+#include "NeuroStrikeProjectilePoolSubsystem.h"
+#include "NeuroStrikeSwarmProjectileSubsystem.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Controller.h"
 #include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
 #include "EnhancedInputSubsystems.h"
+#include "TimerManager.h"
+#include "UObject/SoftObjectPath.h"
 
 UTP_WeaponComponent::UTP_WeaponComponent() {
 	MuzzleOffset = FVector(100.0f, 0.0f, 10.0f);
+
+	// The weapon has no per-frame logic of its own; its pose only matters while someone can see it.
+	this->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+	this->bEnableUpdateRateOptimizations = true;
+	this->OnAnimUpdateRateParamsCreated.BindUObject(this, &UTP_WeaponComponent::OnUpdateRateParamsCreated);
+}
+
+void UTP_WeaponComponent::OnUpdateRateParamsCreated(FAnimUpdateRateParameters* Parameters) {
+	// Key update rates on screen size: full rate above 40% of the screen, then every 2nd, 3rd and 4th frame.
+	Parameters->bShouldUseLodMap = false;
+	Parameters->BaseVisibleDistanceFactorThesholds = {0.4f, 0.2f, 0.1f};
+}
+
+void UTP_WeaponComponent::OnRegister() {
+	Super::OnRegister();
+
+	this->RefreshStats();
+}
+
+void UTP_WeaponComponent::BeginPlay() {
+	Super::BeginPlay();
+
+	if (GetNetMode() == NM_DedicatedServer) {
+		this->SetComponentTickEnabled(false);
+	}
+}
+
+void UTP_WeaponComponent::Serialize(FArchive& Ar) {
+#if WITH_EDITOR
+	// Paths are still saved, only the assets behind them are not cooked along.
+	TOptional<FSoftObjectPathSerializationScope> ServerCookScope;
+	if (NeuroStrikeCook::IsCookingForServer(Ar)) {
+		ServerCookScope.Emplace(ESoftObjectPathCollectType::NeverCollect);
+	}
+#endif
+
+	Super::Serialize(Ar);
 }
 
 void UTP_WeaponComponent::AttachWeapon(ANeuroStrikeCharacter* TargetCharacter) {
@@ -20,38 +67,384 @@ void UTP_WeaponComponent::AttachWeapon(ANeuroStrikeCharacter* TargetCharacter) {
 	}
 
 	FAttachmentTransformRules AttachmentRules(EAttachmentRule::SnapToTarget, true);
-	AttachToComponent(this->Character->GetMesh1P(), AttachmentRules, FName(TEXT("GripPoint")));
+	// Dedicated servers have no first-person arms, and shots only use the character's location and aim there.
+	if (USkeletalMeshComponent* Mesh1P = this->Character->GetMesh1P()) {
+		AttachToComponent(Mesh1P, AttachmentRules, FName(TEXT("GripPoint")));
+	} else {
+		AttachToComponent(this->Character->GetRootComponent(), AttachmentRules);
+	}
 
 	this->Character->SetHasRifle(true);
 	this->Character->WeaponComponent = this;
+	this->RefreshController();
+	this->RefreshStats();
+
+	this->LoadCosmetics();
+
+	// The owning client keeps its own pool of cosmetic projectiles for predicted shots.
+	if (this->Character->HasAuthority() || this->Character->IsLocallyControlled()) {
+		if (UNeuroStrikeProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UNeuroStrikeProjectilePoolSubsystem>()) {
+			Pool->Prewarm(this->Stats->ProjectileClass, this->ProjectilePoolSize);
+		}
+	}
 }
 
-void UTP_WeaponComponent::HandleProjectile() {
-	if (ProjectileClass != nullptr) {
-		UWorld* const World = GetWorld();
-		if (World != nullptr) {
-			APlayerController* PlayerController = Cast<APlayerController>(Character->GetController());
-			const FRotator SpawnRotation = PlayerController->PlayerCameraManager->GetCameraRotation();
-			const FVector SpawnLocation = GetOwner()->GetActorLocation() + SpawnRotation.RotateVector(MuzzleOffset);
+void UTP_WeaponComponent::HandleProjectile(float ShotTime, uint16 ShotId) {
+	NEUROSTRIKE_SCOPE_CYCLE_COUNTER("Weapon HandleProjectile", STAT_NeuroStrike_HandleProjectile);
 
-			FActorSpawnParameters ActorSpawnParams;
-			ActorSpawnParams.SpawnCollisionHandlingOverride =
-				ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+	UWorld* const World = GetWorld();
+	if (World == nullptr) {
+		return;
+	}
+
+	const FNeuroStrikeWeaponStats& WeaponStats = *this->Stats;
+	if (WeaponStats.ShotType == ENeuroStrikeShotType::Projectile && WeaponStats.ProjectileClass == nullptr) {
+		return;
+	}
 
-			World->SpawnActor<ANeuroStrikeProjectile>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
+	FVector SpawnLocation;
+	FRotator SpawnRotation;
+	if (!this->GetMuzzleTransform(SpawnLocation, SpawnRotation)) {
+		return;
+	}
+
+	if (WeaponStats.ShotType == ENeuroStrikeShotType::Hitscan) {
+		if (UNeuroStrikeHitscanSubsystem* Hitscan = World->GetSubsystem<UNeuroStrikeHitscanSubsystem>()) {
+			FNeuroStrikeHitscanRequest Request;
+			Request.Instigator = Character;
+			Request.Start = SpawnLocation;
+			Request.End = SpawnLocation + SpawnRotation.Vector() * WeaponStats.Range;
+			Request.Damage = WeaponStats.RollDamage(FMath::FRand());
+			Request.WeaponStats = this->Stats;
+			Request.TraceChannel = WeaponStats.TraceChannel;
+			Request.ShotTime = ShotTime;
+			Request.bLagCompensated = !Character->IsLocallyControlled();
+			Request.QueueTime = World->GetTimeSeconds();
+			Hitscan->QueueShot(Request);
 		}
+		return;
+	}
+
+	if (WeaponStats.ShotType == ENeuroStrikeShotType::Swarm) {
+		this->SpawnSwarm(SpawnLocation, SpawnRotation, ShotId, false);
+		return;
+	}
+
+	if (UNeuroStrikeProjectilePoolSubsystem* Pool = World->GetSubsystem<UNeuroStrikeProjectilePoolSubsystem>()) {
+		Pool->Acquire(WeaponStats.ProjectileClass, SpawnLocation, SpawnRotation, Character, ShotId, this->Stats);
 	}
 }
 
 void UTP_WeaponComponent::HandleProjectileFX() {
-	if (FireSound != nullptr) {
-		UGameplayStatics::PlaySoundAtLocation(this, FireSound, Character->GetActorLocation());
+	if (USoundBase* Sound = this->FireSound.Get()) {
+		UGameplayStatics::PlaySoundAtLocation(this, Sound, Character->GetActorLocation());
 	}
 
-	if (FireAnimation != nullptr) {
-		UAnimInstance* AnimInstance = Character->GetMesh1P()->GetAnimInstance();
+	const USkeletalMeshComponent* Mesh1P = Character->GetMesh1P();
+	UAnimMontage* Montage = this->FireAnimation.Get();
+	if (Montage != nullptr && Mesh1P != nullptr) {
+		UAnimInstance* AnimInstance = Mesh1P->GetAnimInstance();
 		if (AnimInstance != nullptr) {
-			AnimInstance->Montage_Play(FireAnimation, 1.f);
+			AnimInstance->Montage_Play(Montage, 1.f);
 		}
 	}
 }
+
+void UTP_WeaponComponent::LoadCosmetics() {
+	if (this->CosmeticsHandle.IsValid()) {
+		return;
+	}
+
+	TArray<FSoftObjectPath> Assets;
+	if (!this->FireSound.IsNull()) {
+		Assets.Add(this->FireSound.ToSoftObjectPath());
+	}
+	if (!this->FireAnimation.IsNull()) {
+		Assets.Add(this->FireAnimation.ToSoftObjectPath());
+	}
+
+	if (UNeuroStrikePreloadSubsystem* Preload = GetWorld()->GetSubsystem<UNeuroStrikePreloadSubsystem>()) {
+		this->CosmeticsHandle = Preload->RequestAsyncLoad(Assets, true);
+	}
+}
+
+void UTP_WeaponComponent::StartFiring(float StartTime, uint16 FirstShotId) {
+	if (this->Character == nullptr) {
+		return;
+	}
+
+	// A sequence still running here means the next press arrived early, e.g. through network jitter. Its
+	// remaining shots are dropped rather than fired all at once.
+	if (this->IsFiring()) {
+		this->CancelFiring();
+	}
+
+	const UWorld* World = GetWorld();
+	const float Interval = this->GetShotInterval();
+	const float Now = World->GetTimeSeconds();
+
+	if (this->Character->HasAuthority()) {
+		// Never trust a client to fire faster than the cadence or to schedule shots in the future. The server
+		// schedules in its own clock, from the clamped time only.
+		float EffectiveStartTime = FMath::Min(StartTime, Now);
+		if (this->LastShotTime >= 0.0f) {
+			EffectiveStartTime = FMath::Max(EffectiveStartTime, this->LastShotTime + Interval);
+		}
+
+		this->FireStartTime = EffectiveStartTime;
+		this->FireStartLocalTime = EffectiveStartTime;
+	} else {
+		// Shot times are in the server's clock, but the schedule runs in the local one.
+		this->FireStartTime = StartTime;
+		this->FireStartLocalTime = Now;
+	}
+	this->NextShotId = FirstShotId;
+	this->ShotsFired = 0;
+
+	switch (this->Stats->FireMode) {
+	case ENeuroStrikeFireMode::Burst:
+		this->MaxShots = this->Stats->BurstCount;
+		break;
+	case ENeuroStrikeFireMode::Auto:
+		this->MaxShots = INDEX_NONE;
+		break;
+	default:
+		this->MaxShots = 1;
+		break;
+	}
+
+	if (this->Character->HasAuthority()) {
+		this->Character->NotifyFireStarted(this->FireStartTime, FirstShotId, this->MaxShots);
+	}
+
+	this->FireDueShots();
+	if (this->IsFiring()) {
+		const float FirstDelay = FMath::Max(this->FireStartLocalTime + this->ShotsFired * Interval - Now,
+		                                    KINDA_SMALL_NUMBER);
+		World->GetTimerManager().SetTimer(this->FireTimerHandle, this, &UTP_WeaponComponent::FireDueShots, Interval,
+		                                  true, FirstDelay);
+	}
+}
+
+void UTP_WeaponComponent::StopFiring(float StopTime, uint16 LastShotId) {
+	if (!this->IsFiring() || this->Stats->FireMode != ENeuroStrikeFireMode::Auto) {
+		return;
+	}
+
+	// Shot ids wrap around, so the count is taken from their 16-bit difference.
+	const uint16 FirstShotId = static_cast<uint16>(this->NextShotId - this->ShotsFired);
+	int32 ShotCount = static_cast<uint16>(LastShotId - FirstShotId) + 1;
+
+	if (this->Character != nullptr && this->Character->HasAuthority()) {
+		const int32 CadenceLimit = FMath::FloorToInt(
+			(StopTime - this->FireStartTime) / this->GetShotInterval() + KINDA_SMALL_NUMBER) + 1;
+		ShotCount = FMath::Min(ShotCount, FMath::Max(CadenceLimit, 1));
+	}
+
+	this->LimitFiring(ShotCount);
+}
+
+void UTP_WeaponComponent::LimitFiring(int32 ShotCount) {
+	this->MaxShots = FMath::Max(ShotCount, this->ShotsFired);
+	if (this->Character != nullptr && this->Character->HasAuthority()) {
+		this->Character->NotifyFireStopped(this->MaxShots);
+	}
+
+	if (!this->IsFiring()) {
+		this->FinishFiring();
+	}
+}
+
+bool UTP_WeaponComponent::CanStartFiring(float StartTime) const {
+	return !this->IsFiring()
+		&& (this->LastShotTime < 0.0f || StartTime >= this->LastShotTime + this->GetShotInterval());
+}
+
+bool UTP_WeaponComponent::IsFiring() const {
+	return this->MaxShots == INDEX_NONE || this->ShotsFired < this->MaxShots;
+}
+
+void UTP_WeaponComponent::CancelFiring() {
+	this->LimitFiring(this->ShotsFired);
+}
+
+float UTP_WeaponComponent::GetShotInterval() const {
+	return this->Stats->ShotInterval;
+}
+
+void UTP_WeaponComponent::FireDueShots() {
+	const float Interval = this->GetShotInterval();
+	const float Elapsed = GetWorld()->GetTimeSeconds() - this->FireStartLocalTime;
+	const int32 DueShots = Elapsed < 0.0f ? 0 : FMath::FloorToInt(Elapsed / Interval + KINDA_SMALL_NUMBER) + 1;
+
+	const int32 LastShot = FMath::Min(DueShots, this->ShotsFired + this->MaxCatchUpShots);
+	while (this->IsFiring() && this->ShotsFired < LastShot) {
+		this->FireShot(this->FireStartTime + this->ShotsFired * Interval);
+	}
+
+	if (!this->IsFiring()) {
+		this->FinishFiring();
+	}
+}
+
+void UTP_WeaponComponent::FireShot(float ShotTime) {
+	const uint16 ShotId = this->NextShotId++;
+	++this->ShotsFired;
+	this->LastShotTime = ShotTime;
+
+	if (this->Character == nullptr) {
+		return;
+	}
+
+	if (this->Character->HasAuthority()) {
+		this->Character->Shoot(ShotTime, ShotId);
+	} else if (this->Character->IsLocallyControlled()) {
+		this->PredictShot(ShotTime, ShotId);
+	} else {
+		this->PlayRemoteShot(ShotId);
+	}
+}
+
+void UTP_WeaponComponent::PlayRemoteShot(uint16 ShotId) {
+	this->HandleProjectileFX();
+
+	// The shot id seeds the spread, so the cosmetic pellets follow the server's.
+	if (this->Stats->ShotType == ENeuroStrikeShotType::Swarm) {
+		FVector SpawnLocation;
+		FRotator SpawnRotation;
+		if (this->GetMuzzleTransform(SpawnLocation, SpawnRotation)) {
+			this->SpawnSwarm(SpawnLocation, SpawnRotation, ShotId, true);
+		}
+	}
+}
+
+void UTP_WeaponComponent::FinishFiring() {
+	if (const UWorld* World = GetWorld()) {
+		World->GetTimerManager().ClearTimer(this->FireTimerHandle);
+	}
+}
+
+bool UTP_WeaponComponent::ConsumePredictedShot(uint16 ShotId) {
+	return this->PredictedShotIds.RemoveSingleSwap(ShotId, false) > 0;
+}
+
+void UTP_WeaponComponent::RefreshController() {
+	this->CachedController = this->Character != nullptr ? this->Character->GetController() : nullptr;
+}
+
+bool UTP_WeaponComponent::GetMuzzleTransform(FVector& OutLocation, FRotator& OutRotation) const {
+	if (this->Character == nullptr) {
+		return false;
+	}
+
+	// The control rotation is what the first-person camera follows, and on the server it is the rotation the
+	// owning client sent with its moves, so neither side needs the camera manager.
+	if (const AController* Controller = this->CachedController.Get()) {
+		OutRotation = Controller->GetControlRotation();
+	} else {
+		OutRotation = this->Character->GetReplicatedAimRotation();
+	}
+
+	// The weapon actor hangs off the first-person grip on clients but off the root on dedicated servers, so shots
+	// start from the character's eyes instead, which every machine places alike.
+	OutLocation = this->Character->GetPawnViewLocation() + OutRotation.RotateVector(this->Stats->MuzzleOffset);
+	return true;
+}
+
+void UTP_WeaponComponent::PredictShot(float ShotTime, uint16 ShotId) {
+	this->HandleProjectileFX();
+
+	FVector SpawnLocation;
+	FRotator SpawnRotation;
+	if (!this->GetMuzzleTransform(SpawnLocation, SpawnRotation)) {
+		return;
+	}
+
+	const FNeuroStrikeWeaponStats& WeaponStats = *this->Stats;
+
+	// FireToHealth only counts health drops of the character the shot hit as the shooter saw it. Hitscan shots
+	// are not simulated locally, so only while it is measured does finding their victim cost an extra trace.
+	UNeuroStrikeLatencySubsystem* Latency = GetWorld()->GetSubsystem<UNeuroStrikeLatencySubsystem>();
+	if (WeaponStats.ShotType == ENeuroStrikeShotType::Hitscan && Latency != nullptr
+		&& Latency->IsFireToHealthEnabled()) {
+		FHitResult Hit;
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PredictedShotTarget), false, this->Character);
+		if (GetWorld()->LineTraceSingleByChannel(Hit, SpawnLocation,
+		                                         SpawnLocation + SpawnRotation.Vector() * WeaponStats.Range,
+		                                         WeaponStats.TraceChannel, QueryParams)) {
+			if (const ANeuroStrikeCharacter* Victim = Cast<ANeuroStrikeCharacter>(Hit.GetActor())) {
+				Latency->NotifyLocalShot(this->Character, ShotTime, Victim);
+			}
+		}
+	}
+
+	if (WeaponStats.ShotType == ENeuroStrikeShotType::Hitscan
+		|| (WeaponStats.ShotType == ENeuroStrikeShotType::Projectile && WeaponStats.ProjectileClass == nullptr)) {
+		return;
+	}
+
+	if (WeaponStats.ShotType == ENeuroStrikeShotType::Swarm) {
+		this->SpawnSwarm(SpawnLocation, SpawnRotation, ShotId, true);
+		return;
+	}
+
+	UNeuroStrikeProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UNeuroStrikeProjectilePoolSubsystem>();
+	if (Pool == nullptr || Pool->Acquire(WeaponStats.ProjectileClass, SpawnLocation, SpawnRotation, this->Character,
+	                                     ShotId, this->Stats) == nullptr) {
+		return;
+	}
+
+	// Shots the server never confirms must not pile up; only the most recent ones can still be matched.
+	constexpr int32 MaxPendingPredictions = 32;
+	if (this->PredictedShotIds.Num() >= MaxPendingPredictions) {
+		this->PredictedShotIds.RemoveAt(0, 1, false);
+	}
+	this->PredictedShotIds.Add(ShotId);
+}
+
+void UTP_WeaponComponent::SpawnSwarm(const FVector& Location, const FRotator& Rotation, int32 Seed, bool bCosmetic) {
+	UNeuroStrikeSwarmProjectileSubsystem* Swarm = GetWorld()->GetSubsystem<UNeuroStrikeSwarmProjectileSubsystem>();
+	if (Swarm == nullptr) {
+		return;
+	}
+
+	// Pellets are resolved by the swarm simulation, which knows nothing about the weapon, so their damage is
+	// rolled here and does not fall off with distance.
+	const FNeuroStrikeWeaponStats& WeaponStats = *this->Stats;
+	const FRandomStream Spread(Seed);
+	const FVector Direction = Rotation.Vector();
+	for (int32 Index = 0; Index < WeaponStats.PelletCount; ++Index) {
+		const FVector PelletDirection = Spread.VRandCone(Direction, WeaponStats.SpreadHalfAngle);
+		Swarm->SpawnProjectile(this->Character, Location, PelletDirection * WeaponStats.ProjectileSpeed,
+		                       WeaponStats.ProjectileLifetime, WeaponStats.RollDamage(Spread.FRand()),
+		                       bCosmetic);
+	}
+}
+
+void UTP_WeaponComponent::RefreshStats() {
+	if (this->Definition != nullptr) {
+		this->Stats = this->Definition->GetStats();
+		return;
+	}
+
+	TSharedRef<FNeuroStrikeWeaponStats> Baked = MakeShared<FNeuroStrikeWeaponStats>();
+	Baked->ShotType = this->ShotType;
+	Baked->FireMode = this->FireMode;
+	Baked->TraceChannel = this->HitscanTraceChannel;
+	Baked->BurstCount = FMath::Max(this->BurstCount, 1);
+	Baked->ShotInterval = 60.0f / FMath::Max(this->RoundsPerMinute, 1.0f);
+	Baked->Range = this->HitscanRange;
+	Baked->MuzzleOffset = this->MuzzleOffset;
+	Baked->ProjectileClass = this->ProjectileClass;
+
+	if (this->ShotType == ENeuroStrikeShotType::Swarm) {
+		Baked->PelletCount = FMath::Max(this->SwarmPelletCount, 1);
+		Baked->SpreadHalfAngle = FMath::DegreesToRadians(this->SwarmSpreadAngle);
+		Baked->ProjectileSpeed = this->SwarmPelletSpeed;
+		Baked->ProjectileLifetime = this->SwarmPelletLifetime;
+		Baked->MinDamage = this->SwarmPelletDamage;
+		Baked->MaxDamage = this->SwarmPelletDamage;
+	}
+
+	this->Stats = Baked;
+}
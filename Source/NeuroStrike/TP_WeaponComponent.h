@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Engine/StreamableManager.h"
+#include "NeuroStrikeWeaponDefinition.h"
 #include "TP_WeaponComponent.generated.h"
 
 class ANeuroStrikeCharacter;
@@ -23,20 +25,108 @@ public:
 	 */
 	UTP_WeaponComponent();
 
+	/** Bakes the weapon stats as soon as the component is registered, so they exist before the first shot. */
+	virtual void OnRegister() override;
+
+	/** Stops ticking on dedicated servers, where the weapon mesh is never rendered or animated. */
+	virtual void BeginPlay() override;
+
+	/** Keeps the fire sound and animation out of server cooks, which never load them. */
+	virtual void Serialize(FArchive& Ar) override;
+
+	/**
+	 * Configures update rate optimizations of the weapon mesh once their parameters exist.
+	 *
+	 * @param Parameters The update rate parameters of the mesh.
+	 */
+	void OnUpdateRateParamsCreated(FAnimUpdateRateParameters* Parameters);
+
+	/**
+	 * Data asset describing how the weapon fires and what its hits deal.
+	 * When set it replaces the fire, projectile, hitscan and swarm properties below, which remain for weapons that
+	 * have not been moved to a definition yet.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	TObjectPtr<UNeuroStrikeWeaponDefinition> Definition;
+
+	/** Whether shots are simulated projectiles, instant hitscan traces or swarms of lightweight pellets */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile)
+	ENeuroStrikeShotType ShotType = ENeuroStrikeShotType::Projectile;
+
 	/** The class type for the projectile spawned when the weapon fires */
 	UPROPERTY(EditDefaultsOnly, Category=Projectile)
 	TSubclassOf<class ANeuroStrikeProjectile> ProjectileClass;
 
-	/** Sound effect played when the weapon is fired */
+	/**
+	 * Number of projectiles pre-warmed in the projectile pool when the weapon is attached on the server.
+	 * Should match the number of this weapon's projectiles that can be in flight at once.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile, meta=(ClampMin="0"))
+	int32 ProjectilePoolSize = 32;
+
+	/**
+	 * Most shots fired in a single update when the sequence is behind its schedule, e.g. after a hitch or when
+	 * the server catches up with a press the client made in the past. The rest follow on later updates.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon, meta=(ClampMin="1"))
+	int32 MaxCatchUpShots = 2;
+
+	/** Maximum distance a hitscan shot travels from the muzzle */
+	UPROPERTY(EditDefaultsOnly, Category=Hitscan, meta=(EditCondition="ShotType == ENeuroStrikeShotType::Hitscan"))
+	float HitscanRange = 10000.0f;
+
+	/** Collision channel hitscan shots are traced against */
+	UPROPERTY(EditDefaultsOnly, Category=Hitscan, meta=(EditCondition="ShotType == ENeuroStrikeShotType::Hitscan"))
+	TEnumAsByte<ECollisionChannel> HitscanTraceChannel = ECC_Visibility;
+
+	/** Number of pellets fired by a single swarm shot */
+	UPROPERTY(EditDefaultsOnly, Category=Swarm,
+	          meta=(ClampMin="1", EditCondition="ShotType == ENeuroStrikeShotType::Swarm"))
+	int32 SwarmPelletCount = 8;
+
+	/** Half-angle in degrees of the cone swarm pellets are spread over */
+	UPROPERTY(EditDefaultsOnly, Category=Swarm,
+	          meta=(ClampMin="0", EditCondition="ShotType == ENeuroStrikeShotType::Swarm"))
+	float SwarmSpreadAngle = 4.0f;
+
+	/** Speed of swarm pellets, in units per second */
+	UPROPERTY(EditDefaultsOnly, Category=Swarm,
+	          meta=(ClampMin="1", EditCondition="ShotType == ENeuroStrikeShotType::Swarm"))
+	float SwarmPelletSpeed = 6000.0f;
+
+	/** Seconds after which a swarm pellet that hit nothing expires */
+	UPROPERTY(EditDefaultsOnly, Category=Swarm,
+	          meta=(ClampMin="0.01", EditCondition="ShotType == ENeuroStrikeShotType::Swarm"))
+	float SwarmPelletLifetime = 1.0f;
+
+	/** Damage dealt by a single swarm pellet */
+	UPROPERTY(EditDefaultsOnly, Category=Swarm,
+	          meta=(ClampMin="0", EditCondition="ShotType == ENeuroStrikeShotType::Swarm"))
+	float SwarmPelletDamage = 3.0f;
+
+	/** How trigger presses are turned into shots */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon)
+	ENeuroStrikeFireMode FireMode = ENeuroStrikeFireMode::Semi;
+
+	/** Maximum cadence of the weapon, in rounds per minute. Applies to every fire mode */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon, meta=(ClampMin="1"))
+	float RoundsPerMinute = 600.0f;
+
+	/** Number of shots fired per trigger press in burst mode */
+	UPROPERTY(EditDefaultsOnly, Category=Weapon,
+		meta=(ClampMin="1", EditCondition="FireMode == ENeuroStrikeFireMode::Burst"))
+	int32 BurstCount = 3;
+
+	/** Sound effect played when the weapon is fired. Streamed in when the weapon is picked up */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Gameplay)
-	USoundBase* FireSound;
+	TSoftObjectPtr<USoundBase> FireSound;
 
-	/** Animation montage played when the weapon is fired */
+	/** Animation montage played when the weapon is fired. Streamed in when the weapon is picked up */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-	UAnimMontage* FireAnimation;
+	TSoftObjectPtr<UAnimMontage> FireAnimation;
 
 	/**
-	 * Offset applied to the weapon's muzzle location when spawning projectiles.
+	 * Offset of the muzzle from the character's eyes, in aim space, applied when spawning projectiles.
 	 * Typically used to ensure projectiles are spawned in front of the weapon to avoid collision
 	 * with the owning actor or nearby objects.
 	 */
@@ -54,28 +144,232 @@ public:
 	void AttachWeapon(ANeuroStrikeCharacter* TargetCharacter);
 
 	/**
-	 * Handles the spawning of a projectile at the weapon's muzzle location.
+	 * Handles the launching of a shot at the weapon's muzzle location.
 	 * This method determines the spawn position and rotation based on the character's
-	 * camera and applies a defined muzzle offset. If a valid projectile class is set
-	 * and the world context exists, the method spawns the projectile with
-	 * collision handling specified to avoid unintended overlaps.
+	 * camera and applies a defined muzzle offset. Projectile weapons take a projectile from
+	 * the projectile pool, skipping the shot if the muzzle location is blocked. Hitscan weapons
+	 * queue a trace that the server resolves together with the rest of the frame's shots.
+	 *
+	 * @param ShotTime The server world time the shot was fired at. Hitscan shots of remote
+	 *                 players are resolved against the world rewound to this time, while
+	 *                 projectiles always start from the current world state.
+	 * @param ShotId Sequence number of the shot, replicated with the projectile so the owning
+	 *               client can match it with its predicted copy.
 	 */
 	UFUNCTION()
-	void HandleProjectile();
+	void HandleProjectile(float ShotTime, uint16 ShotId);
 
 	/**
 	 * Handles visual and auditory effects triggered when the weapon is fired.
 	 * Plays a firing sound at the character's location if a valid sound effect is set.
+	 * Effects that are still streaming in are skipped rather than loaded synchronously.
 	 * Executes a firing animation montage if a valid animation is provided and
 	 * the character's anim instance is available.
 	 */
 	UFUNCTION()
 	void HandleProjectileFX();
 
+	/**
+	 * Pulls the trigger and starts a firing sequence.
+	 *
+	 * The sequence is fully described by its start time, the fire mode and the cadence, so the owning client
+	 * and the server run it independently from a single RPC: shot N is fired at StartTime + N * 60 / RoundsPerMinute.
+	 * With authority every shot goes through ANeuroStrikeCharacter::Shoot and the sequence is published to other
+	 * clients; the owning client predicts its shots and counts them so it can tell the server how many it fired,
+	 * and other clients replay the published sequence for its effects only. A sequence that is still running when
+	 * the next one starts is cancelled. The server never starts a sequence earlier than the cadence allows after
+	 * the previous shot.
+	 *
+	 * @param StartTime The server world time of the trigger press, in the same time base as shot times.
+	 * @param FirstShotId Sequence number of the first shot. Consecutive shots use consecutive numbers.
+	 */
+	void StartFiring(float StartTime, uint16 FirstShotId);
+
+	/**
+	 * Releases the trigger of an automatic weapon.
+	 *
+	 * The sequence ends once the shot with LastShotId has been fired. The server additionally caps the number of
+	 * shots to what the cadence allows between the start and stop times. Semi and burst sequences ignore the
+	 * release and always run to their shot count.
+	 *
+	 * @param StopTime The server world time of the trigger release.
+	 * @param LastShotId Sequence number of the last shot the client fired.
+	 */
+	void StopFiring(float StopTime, uint16 LastShotId);
+
+	/**
+	 * Checks whether the trigger may be pulled again without exceeding the cadence.
+	 *
+	 * @param StartTime The server world time the trigger would be pulled at.
+	 * @return true if no sequence is running and the previous shot is at least one shot interval old.
+	 */
+	bool CanStartFiring(float StartTime) const;
+
+	/**
+	 * Checks whether a firing sequence is still running.
+	 *
+	 * @return true if more shots of the current sequence are due.
+	 */
+	bool IsFiring() const;
+
+	/** Ends the current firing sequence right away, without firing the shots that are still due. */
+	void CancelFiring();
+
+	/**
+	 * Ends the current firing sequence once it has fired a number of shots, whatever its fire mode. With
+	 * authority the new length is published to other clients through the character's fire state.
+	 *
+	 * @param ShotCount Shots the sequence fires in total. Shots already fired are never taken back.
+	 */
+	void LimitFiring(int32 ShotCount);
+
+	/**
+	 * Retrieves the sequence number the next shot will use.
+	 *
+	 * @return The next shot sequence number.
+	 */
+	uint16 GetNextShotId() const {
+		return this->NextShotId;
+	}
+
+	/**
+	 * Retrieves the time between two shots.
+	 *
+	 * @return The shot interval in seconds.
+	 */
+	float GetShotInterval() const;
+
+	/**
+	 * Marks a predicted shot as matched by the authoritative projectile that arrived from the server.
+	 *
+	 * @param ShotId Sequence number of the authoritative shot.
+	 * @return true if this client predicted the shot and shows its own copy, false if the authoritative
+	 *         projectile has to be shown.
+	 */
+	bool ConsumePredictedShot(uint16 ShotId);
+
+	/** Caches the controller of the owning character. Called on attachment and whenever it is possessed. */
+	void RefreshController();
+
+	/**
+	 * Bakes the stats the fire and damage paths read, from the definition if there is one and from the legacy
+	 * properties otherwise. Called on registration and attachment; properties changed afterwards are ignored
+	 * until the next call.
+	 */
+	void RefreshStats();
+
+	/**
+	 * Retrieves the baked stats of the weapon.
+	 *
+	 * @return The immutable stats of the weapon, shared with the definition and the projectiles it fires.
+	 */
+	const FNeuroStrikeWeaponStats& GetStats() const {
+		return *this->Stats;
+	}
+
 private:
+	/**
+	 * Computes where shots leave the weapon, the same way on the server and on every client.
+	 *
+	 * @param OutLocation Receives the world location of the muzzle: the character's view location plus the
+	 *                    muzzle offset rotated by the aim.
+	 * @param OutRotation Receives the aim direction: the cached controller's control rotation, or the
+	 *                    owning character's replicated aim if it has no controller on this machine.
+	 * @return false if the weapon has no owning character to aim with.
+	 */
+	bool GetMuzzleTransform(FVector& OutLocation, FRotator& OutRotation) const;
+
+	/**
+	 * Gives immediate feedback for a shot fired by the owning client.
+	 *
+	 * Plays the fire effects and, for projectile weapons, launches a cosmetic projectile from the local pool
+	 * without waiting for the server. The server's projectile for the same shot id is hidden on arrival.
+	 * Swarm weapons spawn cosmetic pellets, since the server's pellets are never replicated. While FireToHealth is
+	 * measured, the character a hitscan shot hits is traced for and handed to the latency subsystem.
+	 *
+	 * @param ShotTime Time the shot was due, in the server's clock as estimated by the client.
+	 * @param ShotId Sequence number of the predicted shot.
+	 */
+	void PredictShot(float ShotTime, uint16 ShotId);
+
+	/**
+	 * Plays a shot of another character's replicated firing sequence: its effects and, for swarm weapons, its
+	 * cosmetic pellets.
+	 *
+	 * @param ShotId Sequence number of the shot, which seeds the pellet spread like on the server.
+	 */
+	void PlayRemoteShot(uint16 ShotId);
+
+	/**
+	 * Adds the pellets of a swarm shot to the swarm projectile simulation.
+	 *
+	 * @param Location World location of the muzzle.
+	 * @param Rotation Aim direction the pellets are spread around.
+	 * @param Seed Seed of the spread; the same seed yields the same pellet directions on every machine.
+	 * @param bCosmetic Whether the pellets are only displayed and never deal damage.
+	 */
+	void SpawnSwarm(const FVector& Location, const FRotator& Rotation, int32 Seed, bool bCosmetic);
+
+	/**
+	 * Fires every shot of the current sequence that is due by now.
+	 *
+	 * Driven by a looping timer at the shot interval, but the shots are derived from the elapsed time rather
+	 * than from timer callbacks, so frame hitches never change the number or the times of the shots. At most
+	 * MaxCatchUpShots are fired per call; a sequence that is further behind catches up over the next calls.
+	 */
+	void FireDueShots();
+
+	/**
+	 * Fires a single shot of the current sequence, or predicts it on the owning client.
+	 *
+	 * @param ShotTime The server world time of the shot.
+	 */
+	void FireShot(float ShotTime);
+
+	/** Ends the current firing sequence. */
+	void FinishFiring();
+
+	/** Server world time of the first shot of the current sequence. */
+	float FireStartTime = 0.0f;
+
+	/** Local world time at which the first shot of the current sequence is due. */
+	float FireStartLocalTime = 0.0f;
+
+	/** Server world time of the last shot fired, used to enforce the cadence across sequences. */
+	float LastShotTime = -1.0f;
+
+	/** Number of shots of the current sequence fired so far. */
+	int32 ShotsFired = 0;
+
+	/** Number of shots the current sequence may fire, or INDEX_NONE while an automatic trigger is held. */
+	int32 MaxShots = 0;
+
+	/** Sequence number of the next shot. */
+	uint16 NextShotId = 0;
+
+	/** Timer driving the current firing sequence. */
+	FTimerHandle FireTimerHandle;
+
+	/**
+	 * Starts streaming the fire sound and montage. Does nothing on dedicated servers, which never play them.
+	 */
+	void LoadCosmetics();
+
+	/** Keeps the streamed fire sound and montage loaded while the weapon exists. */
+	TSharedPtr<FStreamableHandle> CosmeticsHandle;
+
+	/** Predicted projectile shots that have not been matched by an authoritative projectile yet. */
+	TArray<uint16, TInlineAllocator<16>> PredictedShotIds;
+
 	/** Reference to the Neuro Strike character currently associated with the weapon component.
 	 *  Tracks the owning character and enables interaction between the character and the weapon,
 	 *  such as determining attachment and possession status.
 	 */
 	ANeuroStrikeCharacter* Character;
+
+	/** Controller of the owning character, cached so shots do not look it up. Null for simulated proxies. */
+	TWeakObjectPtr<AController> CachedController;
+
+	/** Stats baked by RefreshStats. Never null once the component is registered. */
+	TSharedRef<const FNeuroStrikeWeaponStats> Stats = MakeShared<const FNeuroStrikeWeaponStats>();
 };